@@ -0,0 +1,497 @@
+// Author: Yipeng Sun, Alex Fernez
+// License: BSD 2-clause
+
+// Alex note to self: here the filename "default" just refers to the fact that the nominal
+// parameter values for the D** decays have been reset to the paper values (ie. not our shifted
+// values that we chose because the fit seemed to want to move these FF params far from the paper
+// values); the corresponding set nominal values and corresponding variations are thus different
+// from the reweighter script in this folder without "default" in the filename
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Hammer/Hammer.hh>
+
+using std::function;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace ffDst10Sig {
+
+// clang-format off
+// +, -, +, -, ...
+vector<vector<string>> BtoDVars = {
+  // shifting 1-th param in + direction....
+  {
+    "{ap: [0.01564266061259705, -0.034768835742855116, -0.09341578728622298, 0.0]}",
+    "{a0: [0.07921507727285786, -0.20200574935567273, -0.32999651965104015, 0.0]}",
+  },
+  // shifting 1-th param in - direction....
+  {
+    "{ap: [0.015677339387402952, -0.03363116425714489, -0.08658421271377702, 0.0]}",
+    "{a0: [0.07948492272714215, -0.20799425064432725, -0.13000348034895984, 0.0]}",
+  },
+  // shifting 2-th param in + direction....
+  {
+    "{ap: [0.0156957728134992, -0.03274798737619618, -0.11173093154013228, 0.0]}",
+    "{a0: [0.07952054730874657, -0.20479549469640895, -0.22925983421113325, 0.0]}",
+  },
+  // shifting 2-th param in - direction....
+  {
+    "{ap: [0.015624227186500802, -0.035652012623803825, -0.06826906845986772, 0.0]}",
+    "{a0: [0.07917945269125344, -0.20520450530359102, -0.23074016578886677, 0.0]}",
+  },
+  // shifting 3-th param in + direction....
+  {
+    "{ap: [0.015686808500749508, -0.031712849151909125, -0.08969198838997502, 0.0]}",
+    "{a0: [0.07939582669134693, -0.19132668876796238, -0.22961524687243018, 0.0]}",
+  },
+  // shifting 3-th param in - direction....
+  {
+    "{ap: [0.015633191499250493, -0.03668715084809088, -0.09030801161002497, 0.0]}",
+    "{a0: [0.07930417330865308, -0.2186733112320376, -0.23038475312756984, 0.0]}",
+  },
+  // shifting 4-th param in + direction....
+  {
+    "{ap: [0.015564244420542984, -0.03420228477497694, -0.09000030258603699, 0.0]}",
+    "{a0: [0.07887140238985467, -0.20499939148119928, -0.22999994184165481, 0.0]}",
+  },
+  // shifting 4-th param in - direction....
+  {
+    "{ap: [0.015755755579457017, -0.03419771522502306, -0.089999697413963, 0.0]}",
+    "{a0: [0.07982859761014534, -0.2050006085188007, -0.2300000581583452, 0.0]}",
+  },
+  // shifting 5-th param in + direction....
+  {
+    "{ap: [0.015685136124387915, -0.03519607262617201, -0.09006434570610047, 0.0]}",
+    "{a0: [0.07914343789044714, -0.2048177906662987, -0.22998668416129328, 0.0]}",
+  },
+  // shifting 5-th param in - direction....
+  {
+    "{ap: [0.015634863875612085, -0.03320392737382799, -0.08993565429389952, 0.0]}",
+    "{a0: [0.07955656210955286, -0.20518220933370127, -0.23001331583870674, 0.0]}",
+  }
+};
+
+vector<vector<string>> BtoDstVars = {
+  // Note: these variations are all manually set to 10sigma instead of 1sigma
+  // shifting 1-th param in + direction....
+  {
+    "{avec: [0.0012465300969462544, -0.006078741080525021, -0.027022644719643378]}",
+    "{bvec: [0.00048156025250519207, 1.9109299873591896e-06, 0.00506796892822629]}",
+    "{cvec: [3.355953586166967e-06, 0.002083037477675795, -0.02204522052306778]}",
+    "{dvec: [0.0020582655123657667, -0.014622323576421525, 0.3470464727296727]}",
+  },
+  // shifting 1-th param in - direction....
+  {
+    "{avec: [0.001235020751053745, -0.005285370279474977, -0.02168068968035662]}",
+    "{bvec: [0.00048400267869480785, 0.00016043351801264078, 0.0003435126717737098]}",
+    "{cvec: [4.4574312013833035e-05, 0.002555375322324204, -0.05062324667693221]}",
+    "{dvec: [0.002046729815634233, -0.000916359303578476, -0.34699235791367267]}",
+  },
+  // shifting 2-th param in + direction....
+  {
+    "{avec: [0.001164237594974296, -0.0026653850340459186, -0.04633165839455134]}",
+    "{bvec: [0.00048505335943473967, -1.735253300333417e-05, 0.002325477279678842]}",
+    "{cvec: [-2.1779232994205136e-05, -0.005533233191349908, 0.1484452829218463]}",
+    "{dvec: [0.0020339935574234572, -0.00982515574159766, -0.007790606662095515]}",
+  },
+  // shifting 2-th param in - direction....
+  {
+    "{avec: [0.0013173132530257035, -0.00869872632595408, -0.0023716760054486585]}",
+    "{bvec: [0.00048050957176526025, 0.00017969698100333414, 0.0030860043203211583]}",
+    "{cvec: [6.970949859420514e-05, 0.010171645991349907, -0.22111375012184628]}",
+    "{dvec: [0.0020710017705765425, -0.005713527138402339, 0.007844721478095515]}",
+  },
+  // shifting 3-th param in + direction....
+  {
+    "{avec: [0.0014937800485939367, -0.014790260007525405, -0.09839611436453814]}",
+    "{bvec: [0.0004692282904880357, 0.00041544409117401447, 0.004262515284802589]}",
+    "{cvec: [9.011383666413758e-05, 0.0019066083870788136, -0.0450451444754436]}",
+    "{dvec: [0.0020714194151520552, -0.01010790006508856, -0.00025156835522024593]}",
+  },
+  // shifting 3-th param in - direction....
+  {
+    "{avec: [0.0009877707994060628, 0.003426148647525407, 0.04969277996453815]}",
+    "{bvec: [0.0004963346407119641, -0.0002530996431740145, 0.001148966315197411]}",
+    "{cvec: [-4.218357106413758e-05, 0.0027318044129211855, -0.027623322724556386]}",
+    "{dvec: [0.0020335759128479445, -0.005430782814911439, 0.0003056831712202459]}",
+  },
+  // shifting 4-th param in + direction....
+  {
+    "{avec: [0.001369170146042264, -0.01230600055107656, -0.022543062861824722]}",
+    "{bvec: [0.0004783648808389333, -0.0008636463452013094, 0.04508860307725271]}",
+    "{cvec: [-6.0607917454812375e-05, 0.0038488052109782065, -0.03593271723285831]}",
+    "{dvec: [0.002101459341855659, -0.012862188209125897, -0.00037139218316628895]}",
+  },
+  // shifting 4-th param in - direction....
+  {
+    "{avec: [0.0011123807019577355, 0.0009418891910765621, -0.026160271538175277]}",
+    "{bvec: [0.0004871980503610666, 0.0010259907932013094, -0.039677121477252705]}",
+    "{cvec: [0.00010853818305481237, 0.0007896075890217924, -0.03673574996714168]}",
+    "{dvec: [0.0020035359861443405, -0.0026764946708741034, 0.0004255069991662889]}",
+  },
+  // shifting 5-th param in + direction....
+  {
+    "{avec: [0.0012196205558262715, -0.0052523382682886114, -0.024793214060702617]}",
+    "{bvec: [0.0004793723178580663, 0.00044236264531985784, 0.0044529584647468486]}",
+    "{cvec: [9.99709987125693e-05, 0.0013156807256480539, -0.036272666561984045]}",
+    "{dvec: [0.0018314591531018646, 0.005668526224921964, 0.00027450204937167936]}",
+  },
+  // shifting 5-th param in - direction....
+  {
+    "{avec: [0.001261930292173728, -0.006111773091711387, -0.023910120339297382]}",
+    "{bvec: [0.0004861906133419336, -0.00028001819731985787, 0.0009585231352531522]}",
+    "{cvec: [-5.204073311256931e-05, 0.0033227320743519453, -0.036395800638015945]}",
+    "{dvec: [0.002273536174898135, -0.021207209104921965, -0.00022038723337167938]}",
+  },
+  // shifting 6-th param in + direction....
+  {
+    "{avec: [0.0012814138164973018, -0.008267343026409062, -0.024139009449046952]}",
+    "{bvec: [0.0004794221071018516, -0.0003744019336643319, 0.002138039907403325]}",
+    "{cvec: [-0.0002497820085051978, 0.008283293510078829, -0.036007641895928866]}",
+    "{dvec: [0.001932584608310705, -0.0071501850939849135, 3.232260675255132e-05]}",
+  },
+  // shifting 6-th param in - direction....
+  {
+    "{avec: [0.0012001370315026978, -0.0030967683335909354, -0.024564324950953047]}",
+    "{bvec: [0.0004861408240981483, 0.0005367463816643319, 0.0032734416925966755]}",
+    "{cvec: [0.00029771227410519774, -0.003644880710078829, -0.036660825304071123]}",
+    "{dvec: [0.0021724107196892948, -0.008388497786015086, 2.1792209247448674e-05]}",
+  },
+  // shifting 7-th param in + direction....
+  {
+    "{avec: [0.0012843702142687969, -0.006412653041316254, -0.02426888037804516]}",
+    "{bvec: [0.0004912622442030115, -0.0010792733850466924, 0.0025823443016507385]}",
+    "{cvec: [-4.289238173878899e-05, 0.001892036455619719, -0.03633097247280449]}",
+    "{dvec: [0.0020932378153919453, -0.007726833683069959, 2.784348983304206e-05]}",
+  },
+  // shifting 7-th param in - direction....
+  {
+    "{avec: [0.0011971806337312027, -0.004951458318683744, -0.02443445402195484]}",
+    "{bvec: [0.0004743006869969884, 0.0012416178330466924, 0.0028291372983492618]}",
+    "{cvec: [9.0822647338789e-05, 0.00274637634438028, -0.036337494727195496]}",
+    "{dvec: [0.0020117575126080544, -0.007811849196930041, 2.6271326166957937e-05]}",
+  },
+  // shifting 8-th param in + direction....
+  {
+    "{avec: [0.0014180123942665649, -0.005679643681207845, -0.02435154108227566]}",
+    "{bvec: [0.0005499882615659136, 9.74964954688785e-05, 0.002706034825926937]}",
+    "{cvec: [5.749844471477067e-05, 0.0023304544770001152, -0.03633354666453006]}",
+    "{dvec: [0.0025221654709425127, -0.0077612251640925755, 2.7193996188637165e-05]}",
+  },
+  // shifting 8-th param in - direction....
+  {
+    "{avec: [0.0010635384537334347, -0.005684467678792153, -0.02435179331772434]}",
+    "{bvec: [0.00041557466963408623, 6.484795253112148e-05, 0.0027054467740730633]}",
+    "{cvec: [-9.56817911477067e-06, 0.002307958322999884, -0.03633492053546993]}",
+    "{dvec: [0.001582829857057487, -0.007777457715907424, 2.692081981136283e-05]}",
+  },
+  // shifting 9-th param in + direction....
+  {
+    "{avec: [0.0011849957135970663, -0.005974991668828165, -0.024315485343657205]}",
+    "{bvec: [0.0005056941533157017, 0.0003198652591399119, 0.0026680212185089757]}",
+    "{cvec: [-7.230744495556924e-05, 0.0022016338683811198, -0.03633012659798523]}",
+    "{dvec: [0.0020731556917226524, -0.007768293450027011, 2.7078831778645917e-05]}",
+  },
+  // shifting 9-th param in - direction....
+  {
+    "{avec: [0.0012965551344029332, -0.005389119691171833, -0.024387849056342795]}",
+    "{bvec: [0.00045986877788429815, -0.00015752081113991193, 0.0027434603814910246]}",
+    "{cvec: [0.00012023771055556925, 0.0024367789316188794, -0.03633834060201476]}",
+    "{dvec: [0.0020318396362773473, -0.007770389429972989, 2.703598422135408e-05]}",
+  },
+  // shifting 10-th param in + direction....
+  {
+    "{avec: [0.0010843791398429444, -0.005667196887414759, -0.024354078616807308]}",
+    "{bvec: [0.00046690408606668424, 6.459274908984185e-05, 0.0027080342611609798]}",
+    "{cvec: [2.6334724289269157e-05, 0.00232700335213522, -0.036334482774126486]}",
+    "{dvec: [0.0021139160274426254, -0.007768418630867613, 2.7071881786327663e-05]}",
+  },
+  // shifting 10-th param in - direction....
+  {
+    "{avec: [0.0013971717081570551, -0.005696914472585239, -0.02434925578319269]}",
+    "{bvec: [0.0004986588451333157, 9.775169891015812e-05, 0.0027034473388390205]}",
+    "{cvec: [2.159554131073084e-05, 0.002311409447864779, -0.0363339844258735]}",
+    "{dvec: [0.0019910793005573743, -0.007770264249132386, 2.7042934213672333e-05]}",
+  },
+  // shifting 11-th param in + direction....
+  {
+    "{avec: [0.0012346853058009702, -0.005685677566489024, -0.024351239731133584]}",
+    "{bvec: [0.000521997411348442, 8.206954100809469e-05, 0.0027052592996004163]}",
+    "{cvec: [4.981979169892542e-05, 0.0023187949863201483, -0.0363341398420916]}",
+    "{dvec: [0.0020473372545730516, -0.007769434970123697, 2.7055913157374695e-05]}",
+  },
+  // shifting 11-th param in - direction....
+  {
+    "{avec: [0.0012468655421990294, -0.005678433793510974, -0.024352094668866415]}",
+    "{bvec: [0.0004435655198515579, 8.027490699190528e-05, 0.002706222300399584]}",
+    "{cvec: [-1.889526098925419e-06, 0.002319617813679851, -0.03633432735790839]}",
+    "{dvec: [0.002057658073426948, -0.007769247909876303, 2.70589028426253e-05]}",
+  },
+  // shifting 12-th param in + direction....
+  {
+    "{avec: [0.0012414250753808162, -0.005685699220444434, -0.024351209123777216]}",
+    "{bvec: [0.0004730355493736248, 8.299681595606507e-05, 0.002705248325108172]}",
+    "{cvec: [3.83162945171957e-05, 0.002318349403817377, -0.03633415212052943]}",
+    "{dvec: [0.002052598312588332, -0.007769340223737234, 2.705742918688994e-05]}",
+  },
+  // shifting 12-th param in - direction....
+  {
+    "{avec: [0.0012401257726191834, -0.005678412139555564, -0.024352125276222783]}",
+    "{bvec: [0.0004925273818263752, 7.93476320439349e-05, 0.002706233274891828]}",
+    "{cvec: [9.613971082804295e-06, 0.002320063396182622, -0.03633431507947056]}",
+    "{dvec: [0.0020523970154116677, -0.007769342656262766, 2.7057386813110055e-05]}",
+  }
+};
+
+vector<vector<string>> BtoD0starVars = {
+  // shifting 1-th param in + direction....
+  {
+    "{ztp: 3.0}",
+    "{zeta1: 0.6}",
+  },
+  // shifting 1-th param in - direction....
+  {
+    "{ztp: -2.5999999999999996}",
+    "{zeta1: 0.6}",
+  },
+  // shifting 2-th param in + direction....
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 1.2}",
+  },
+  // shifting 2-th param in - direction....
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 0.0}",
+  }
+};
+
+vector<vector<string>> BtoD1Vars = {
+  // shifting 1-th param in + direction....
+  {
+    "{tp: -1.2000000000000002}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting 1-th param in - direction....
+  {
+    "{tp: -2.0}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting 2-th param in + direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: 0.09999999999999998}",
+    "{tau2: 2.9}",
+  },
+  // shifting 2-th param in - direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: -1.1}",
+    "{tau2: 2.9}",
+  },
+  // shifting 3-th param in + direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 5.699999999999999}",
+  },
+  // shifting 3-th param in - direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 0.10000000000000009}",
+  },
+};
+
+vector<vector<string>> BtoD1starVars = {
+  // shifting 1-th param in + direction....
+  {
+    "{ztp: 3.0}",
+    "{zeta1: 0.6}",
+  },
+  // shifting 1-th param in - direction....
+  {
+    "{ztp: -2.5999999999999996}",
+    "{zeta1: 0.6}",
+  },
+  // shifting 2-th param in + direction....
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 1.2}",
+  },
+  // shifting 2-th param in - direction....
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 0.0}",
+  },
+};
+
+vector<vector<string>> BtoD2starVars = {
+  // shifting 1-th param in + direction....
+  {
+    "{tp: -1.2000000000000002}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting 1-th param in - direction....
+  {
+    "{tp: -2.0}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting 2-th param in + direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: 0.09999999999999998}",
+    "{tau2: 2.9}",
+  },
+  // shifting 2-th param in - direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: -1.1}",
+    "{tau2: 2.9}",
+  },
+  // shifting 3-th param in + direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 5.699999999999999}",
+  },
+  // shifting 3-th param in - direction....
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 0.10000000000000009}",
+  },
+};
+
+// Various FF config
+map<string, vector<vector<string>>> ffVarSpecs = {
+  {"BD", BtoDVars},
+  {"BD*", BtoDstVars},
+  {"BD**0*", BtoD0starVars},
+  {"BD**1", BtoD1Vars},
+  {"BD**1*", BtoD1starVars},
+  {"BD**2*", BtoD2starVars},
+  {"BsDs**1", BtoD1Vars},
+  {"BsDs**2*", BtoD2starVars}
+};
+
+map<string, string> ffSchemeByDecay = {
+  {"BD", "BGL"},
+  {"BD*", "BGL"},
+  {"BD**0*", "BLR"},
+  {"BD**1", "BLR"},
+  {"BD**1*", "BLR"},
+  {"BD**2*", "BLR"},
+  {"BsDs**1", "BLR"},
+  {"BsDs**2*", "BLR"}
+};
+
+void setBtoDBGLDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {ChiT: 0.0005131}");
+  ham.setOptions(scheme + ": {ChiL: 0.006332}");
+  ham.setOptions(scheme + ": {BcStatesp: [6.329, 6.92, 7.02]}");
+  ham.setOptions(scheme + ": {BcStates0: [6.716, 7.121]}");
+  ham.setOptions(scheme + ": {ap: [0.01566, -0.0342, -0.09, 0.0]}");
+  ham.setOptions(scheme + ": {a0: [0.07935, -0.205, -0.23, 0.0]}");
+}
+
+void setBtoDstarBGLDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {Vcb: 0.0384}");
+  ham.setOptions(scheme + ": {Chim: 0.0003894}");
+  ham.setOptions(scheme + ": {Chip: 0.0005131}");
+  ham.setOptions(scheme + ": {ChimL: 0.019421}");
+  ham.setOptions(scheme + ": {BcStatesf: [6.739, 6.75, 7.145, 7.15]}");
+  ham.setOptions(scheme + ": {BcStatesg: [6.329, 6.92, 7.02]}");
+  ham.setOptions(scheme + ": {BcStatesP1: [6.275, 6.842, 7.25]}");
+  ham.setOptions(scheme + ": {avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}");
+  ham.setOptions(scheme + ": {bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}");
+  ham.setOptions(scheme + ": {cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}");
+  ham.setOptions(scheme + ": {dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}");
+  // Alex note to self: gen_ham_params outputs setOptions(... abcderr: [...10 values...]) too,
+  // but I don't think Hammer needs the errors (they weren't set in previous iterations of Hammer
+  // reweighting, either)
+}
+
+void setBtoD0starBLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {zt1: 0.7}");
+  ham.setOptions(scheme + ": {ztp: 0.2}");
+  ham.setOptions(scheme + ": {zeta1: 0.6}");
+  ham.setOptions(scheme + ": {chi1: 0.0}");
+  ham.setOptions(scheme + ": {chi2: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laS: 0.76}");
+};
+
+void setBtoD1BLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {t1: 0.7}");
+  ham.setOptions(scheme + ": {tp: -1.6}");
+  ham.setOptions(scheme + ": {tau1: -0.5}");
+  ham.setOptions(scheme + ": {tau2: 2.9}");
+  ham.setOptions(scheme + ": {eta1: 0.0}");
+  ham.setOptions(scheme + ": {eta2: 0.0}");
+  ham.setOptions(scheme + ": {eta3: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laP: 0.8}");
+};
+
+void setBtoD1starBLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {zt1: 0.7}");
+  ham.setOptions(scheme + ": {ztp: 0.2}");
+  ham.setOptions(scheme + ": {zeta1: 0.6}");
+  ham.setOptions(scheme + ": {chi1: 0.0}");
+  ham.setOptions(scheme + ": {chi2: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laS: 0.76}");
+};
+
+void setBtoD2starBLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {t1: 0.7}");
+  ham.setOptions(scheme + ": {tp: -1.6}");
+  ham.setOptions(scheme + ": {tau1: -0.5}");
+  ham.setOptions(scheme + ": {tau2: 2.9}");
+  ham.setOptions(scheme + ": {eta1: 0.0}");
+  ham.setOptions(scheme + ": {eta2: 0.0}");
+  ham.setOptions(scheme + ": {eta3: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laP: 0.8}");
+};
+
+map<string, function<void(Hammer::Hammer&, const string)>>
+ffSchemeDefaultsByDecay = {
+  {"BD", setBtoDBGLDefault},
+  {"BD*", setBtoDstarBGLDefault},
+  {"BD**0*", setBtoD0starBLRDefault},
+  {"BD**1", setBtoD1BLRDefault},
+  {"BD**1*", setBtoD1starBLRDefault},
+  {"BD**2*", setBtoD2starBLRDefault},
+  {"BsDs**1", setBtoD1BLRDefault},
+  {"BsDs**2*", setBtoD2starBLRDefault}
+};
+// clang-format on
+
+const int numOfFFVar = 24;
+
+}  // namespace ffDst10Sig
@@ -0,0 +1,468 @@
+// Author: Yipeng Sun, Alex Fernez
+// License: BSD 2-clause
+
+// Variated parameter values generated using utils/gen_ham_params.py, with central
+// values/errors/correlations/related parameter values set in spec/rdx-run2.yml,
+// EXCEPT FOR B->D*, where the parameters/variations are set by hand to match run1 (note
+// that they include a factor of nEW*Vcb=1.0066*0.0406 compared to the values from the
+// last column of table V in 1707.09509)
+// Note (Alex): can't produce run1 B->D because Hammer doesn't seem to have a BCL
+// reweighting class?
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Hammer/Hammer.hh>
+
+using std::function;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace ffDstRun1 {
+
+// clang-format off
+// +, -, +, -, ...
+vector<vector<string>> BtoDVars = {
+  // shifting in 1-th direction (+)...
+  {
+    "{ap: [0.01564266061259705, -0.034768835742855116, -0.09341578728622298, 0.0]}",
+    "{a0: [0.07921507727285786, -0.20200574935567273, -0.32999651965104015, 0.0]}",
+  },
+  // shifting in 1-th direction (-)...
+  {
+    "{ap: [0.015677339387402952, -0.03363116425714489, -0.08658421271377702, 0.0]}",
+    "{a0: [0.07948492272714215, -0.20799425064432725, -0.13000348034895984, 0.0]}",
+  },
+  // shifting in 2-th direction (+)...
+  {
+    "{ap: [0.0156957728134992, -0.03274798737619618, -0.11173093154013228, 0.0]}",
+    "{a0: [0.07952054730874657, -0.20479549469640895, -0.22925983421113325, 0.0]}",
+  },
+  // shifting in 2-th direction (-)...
+  {
+    "{ap: [0.015624227186500802, -0.035652012623803825, -0.06826906845986772, 0.0]}",
+    "{a0: [0.07917945269125344, -0.20520450530359102, -0.23074016578886677, 0.0]}",
+  },
+  // shifting in 3-th direction (+)...
+  {
+    "{ap: [0.015686808500749508, -0.031712849151909125, -0.08969198838997502, 0.0]}",
+    "{a0: [0.07939582669134693, -0.19132668876796238, -0.22961524687243018, 0.0]}",
+  },
+  // shifting in 3-th direction (-)...
+  {
+    "{ap: [0.015633191499250493, -0.03668715084809088, -0.09030801161002497, 0.0]}",
+    "{a0: [0.07930417330865308, -0.2186733112320376, -0.23038475312756984, 0.0]}",
+  },
+  // shifting in 4-th direction (+)...
+  {
+    "{ap: [0.015564244420542984, -0.03420228477497694, -0.09000030258603699, 0.0]}",
+    "{a0: [0.07887140238985467, -0.20499939148119928, -0.22999994184165481, 0.0]}",
+  },
+  // shifting in 4-th direction (-)...
+  {
+    "{ap: [0.015755755579457017, -0.03419771522502306, -0.089999697413963, 0.0]}",
+    "{a0: [0.07982859761014534, -0.2050006085188007, -0.2300000581583452, 0.0]}",
+  },
+  // shifting in 5-th direction (+)...
+  {
+    "{ap: [0.015685136124387915, -0.03519607262617201, -0.09006434570610047, 0.0]}",
+    "{a0: [0.07914343789044714, -0.2048177906662987, -0.22998668416129328, 0.0]}",
+  },
+  // shifting in 5-th direction (-)...
+  {
+    "{ap: [0.015634863875612085, -0.03320392737382799, -0.08993565429389952, 0.0]}",
+    "{a0: [0.07955656210955286, -0.20518220933370127, -0.23001331583870674, 0.0]}",
+  }
+};
+
+// re-ordered these variations by hand to match Phoebe! Ordering is b, c, a, d (her A1, A5, V4, P1)
+vector<vector<string>> BtoDstVars = {
+  // shifting in 1-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0004904155199999999, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 1-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0018799261599999999, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 2-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.026564173999999996]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 2-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.014303785999999999]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 3-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-8.173592e-05, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 3-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00033511727199999995, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 4-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.00465894744]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 4-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0006538873599999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 5-th direction (+)...
+  {
+    "{avec: [0.001401771028, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 5-th direction (-)...
+  {
+    "{avec: [0.0010421329799999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 6-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0071518929999999994, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 6-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, -0.0038824562000000003, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 7-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, 0.0]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 7-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.073562328]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 8-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0028117156479999994, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 8-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0020515715919999997, -0.012996011279999999, 0.0]}",
+  },
+  // shifting in 9-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.006048458079999999, 0.0]}",
+  },
+  // shifting in 9-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.01994356448, 0.0]}",
+  },
+  // shifting in 10-th direction (+)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.015284617039999998, 0.040867959999999995]}",
+  },
+  // shifting in 10-th direction (-)...
+  {
+    "{avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}",
+    "{bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}",
+    "{cvec: [-0.00020842659599999998, 0.0026564173999999996]}",
+    "{dvec: [0.0024316436199999995, -0.01070740552, -0.040867959999999995]}",
+  }
+};
+
+vector<vector<string>> BtoD0starVars = {
+  // shifting in 1-th direction (+)...
+  {
+    "{ztp: 3.0}",
+    "{zeta1: 0.6}",
+  },
+  // shifting in 1-th direction (-)...
+  {
+    "{ztp: -2.5999999999999996}",
+    "{zeta1: 0.6}",
+  },
+  // shifting in 2-th direction (+)...
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 1.2}",
+  },
+  // shifting in 2-th direction (-)...
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 0.0}",
+  }
+};
+
+vector<vector<string>> BtoD1Vars = {
+  // shifting in 1-th direction (+)...
+  {
+    "{tp: -1.2000000000000002}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 1-th direction (-)...
+  {
+    "{tp: -2.0}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 2-th direction (+)...
+  {
+    "{tp: -1.6}",
+    "{tau1: 0.09999999999999998}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 2-th direction (-)...
+  {
+    "{tp: -1.6}",
+    "{tau1: -1.1}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 3-th direction (+)...
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 5.699999999999999}",
+  },
+  // shifting in 3-th direction (-)...
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 0.10000000000000009}",
+  },
+};
+
+vector<vector<string>> BtoD1starVars = {
+  // shifting in 1-th direction (+)...
+  {
+    "{ztp: 3.0}",
+    "{zeta1: 0.6}",
+  },
+  // shifting in 1-th direction (-)...
+  {
+    "{ztp: -2.5999999999999996}",
+    "{zeta1: 0.6}",
+  },
+  // shifting in 2-th direction (+)...
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 1.2}",
+  },
+  // shifting in 2-th direction (-)...
+  {
+    "{ztp: 0.2}",
+    "{zeta1: 0.0}",
+  },
+};
+
+vector<vector<string>> BtoD2starVars = {
+  // shifting in 1-th direction (+)...
+  {
+    "{tp: -1.2000000000000002}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 1-th direction (-)...
+  {
+    "{tp: -2.0}",
+    "{tau1: -0.5}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 2-th direction (+)...
+  {
+    "{tp: -1.6}",
+    "{tau1: 0.09999999999999998}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 2-th direction (-)...
+  {
+    "{tp: -1.6}",
+    "{tau1: -1.1}",
+    "{tau2: 2.9}",
+  },
+  // shifting in 3-th direction (+)...
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 5.699999999999999}",
+  },
+  // shifting in 3-th direction (-)...
+  {
+    "{tp: -1.6}",
+    "{tau1: -0.5}",
+    "{tau2: 0.10000000000000009}",
+  },
+};
+
+// Various FF config
+map<string, vector<vector<string>>> ffVarSpecs = {
+  {"BD", BtoDVars},
+  {"BD*", BtoDstVars},
+  {"BD**0*", BtoD0starVars},
+  {"BD**1", BtoD1Vars},
+  {"BD**1*", BtoD1starVars},
+  {"BD**2*", BtoD2starVars},
+  {"BsDs**1", BtoD1Vars},
+  {"BsDs**2*", BtoD2starVars}
+};
+
+map<string, string> ffSchemeByDecay = {
+  {"BD", "BGL"},
+  {"BD*", "BGL"},
+  {"BD**0*", "BLR"},
+  {"BD**1", "BLR"},
+  {"BD**1*", "BLR"},
+  {"BD**2*", "BLR"},
+  {"BsDs**1", "BLR"},
+  {"BsDs**2*", "BLR"}
+};
+
+void setBtoDBGLDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {ChiT: 0.0005131}");
+  ham.setOptions(scheme + ": {ChiL: 0.006332}");
+  ham.setOptions(scheme + ": {BcStatesp: [6.329, 6.92, 7.02]}");
+  ham.setOptions(scheme + ": {BcStates0: [6.716, 7.121]}");
+  ham.setOptions(scheme + ": {ap: [0.01566, -0.0342, -0.09, 0.0]}");
+  ham.setOptions(scheme + ": {a0: [0.07935, -0.205, -0.23, 0.0]}");
+}
+
+void setBtoDstarBGLDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {Vcb: 0.0406}");
+  ham.setOptions(scheme + ": {Chim: 0.0003894}");
+  ham.setOptions(scheme + ": {Chip: 0.0005131}");
+  ham.setOptions(scheme + ": {ChimL: 0.019421}");
+  ham.setOptions(scheme + ": {BcStatesf: [6.739, 6.75, 7.145, 7.15]}");
+  ham.setOptions(scheme + ": {BcStatesg: [6.329, 6.92, 7.02]}");
+  ham.setOptions(scheme + ": {BcStatesP1: [6.275, 6.842, 7.25]}");
+  ham.setOptions(scheme + ": {avec: [0.0012219520039999999, 0.0016347183999999998, -0.036781164]}");
+  ham.setOptions(scheme + ": {bvec: [0.0004977717527999999, -0.0011851708399999998, 0.020433979999999997]}");
+  ham.setOptions(scheme + ": {cvec: [-0.00020842659599999998, 0.0026564173999999996]}");
+  ham.setOptions(scheme + ": {dvec: [0.0024316436199999995, -0.012996011279999999, 0.0]}");
+}
+
+void setBtoD0starBLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {zt1: 0.7}");
+  ham.setOptions(scheme + ": {ztp: 0.2}");
+  ham.setOptions(scheme + ": {zeta1: 0.6}");
+  ham.setOptions(scheme + ": {chi1: 0.0}");
+  ham.setOptions(scheme + ": {chi2: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laS: 0.76}");
+};
+
+void setBtoD1BLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {t1: 0.7}");
+  ham.setOptions(scheme + ": {tp: -1.6}");
+  ham.setOptions(scheme + ": {tau1: -0.5}");
+  ham.setOptions(scheme + ": {tau2: 2.9}");
+  ham.setOptions(scheme + ": {eta1: 0.0}");
+  ham.setOptions(scheme + ": {eta2: 0.0}");
+  ham.setOptions(scheme + ": {eta3: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laP: 0.8}");
+};
+
+void setBtoD1starBLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {zt1: 0.7}");
+  ham.setOptions(scheme + ": {ztp: 0.2}");
+  ham.setOptions(scheme + ": {zeta1: 0.6}");
+  ham.setOptions(scheme + ": {chi1: 0.0}");
+  ham.setOptions(scheme + ": {chi2: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laS: 0.76}");
+};
+
+void setBtoD2starBLRDefault(Hammer::Hammer& ham, const string scheme) {
+  ham.setOptions(scheme + ": {as: 0.26}");
+  ham.setOptions(scheme + ": {mb: 4.71}");
+  ham.setOptions(scheme + ": {mc: 1.31}");
+  ham.setOptions(scheme + ": {t1: 0.7}");
+  ham.setOptions(scheme + ": {tp: -1.6}");
+  ham.setOptions(scheme + ": {tau1: -0.5}");
+  ham.setOptions(scheme + ": {tau2: 2.9}");
+  ham.setOptions(scheme + ": {eta1: 0.0}");
+  ham.setOptions(scheme + ": {eta2: 0.0}");
+  ham.setOptions(scheme + ": {eta3: 0.0}");
+  ham.setOptions(scheme + ": {laB: 0.4}");
+  ham.setOptions(scheme + ": {laP: 0.8}");
+};
+
+map<string, function<void(Hammer::Hammer&, const string)>>
+ffSchemeDefaultsByDecay = {
+  {"BD", setBtoDBGLDefault},
+  {"BD*", setBtoDstarBGLDefault},
+  {"BD**0*", setBtoD0starBLRDefault},
+  {"BD**1", setBtoD1BLRDefault},
+  {"BD**1*", setBtoD1starBLRDefault},
+  {"BD**2*", setBtoD2starBLRDefault},
+  {"BsDs**1", setBtoD1BLRDefault},
+  {"BsDs**2*", setBtoD2starBLRDefault}
+};
+// clang-format on
+
+const int numOfFFVar = 20;
+
+}  // namespace ffDstRun1
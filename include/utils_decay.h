@@ -0,0 +1,123 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <TInterpreter.h>
+#include <TMath.h>
+#include <ROOT/RDataFrame.hxx>
+
+#include <boost/algorithm/string/join.hpp>
+
+#include "const.h"
+#include "utils_general.h"
+
+using ROOT::RDF::RNode;
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+//////////////////////
+// Decay signatures //
+//////////////////////
+
+const auto BRANCH_ALIAES = vector<pair<string, string>>{
+    {"q2_true", "True_Q2"},
+    {"is_tau", "True_IsTauDecay"},
+    {"b_id", "TRUEID"},
+    {"dau0_id", "TrueHadron_D0_ID"},
+    {"dau1_id", "TrueHadron_D1_ID"},
+    {"dau2_id", "TrueHadron_D2_ID"},
+    {"dau0_gd0_id", "TrueHadron_D0_GD0_ID"},
+    {"dau0_gd1_id", "TrueHadron_D0_GD1_ID"},
+    {"dau0_gd2_id", "TrueHadron_D0_GD2_ID"},
+    {"dau1_gd0_id", "TrueHadron_D1_GD0_ID"},
+    {"dau1_gd1_id", "TrueHadron_D1_GD1_ID"},
+    {"dau1_gd2_id", "TrueHadron_D1_GD2_ID"},
+    {"dau2_gd0_id", "TrueHadron_D2_GD0_ID"},
+    {"dau2_gd1_id", "TrueHadron_D2_GD1_ID"},
+    {"dau2_gd2_id", "TrueHadron_D2_GD2_ID"},
+};
+
+// The signature of a decay is 'is_tau' followed by the absolute IDs of the B
+// meson, its daughters and grand daughters
+const auto DECAY_SIGNATURE = vector<string>{
+    "is_tau",      "b_id",        "dau0_id",     "dau0_gd0_id", "dau0_gd1_id",
+    "dau0_gd2_id", "dau1_id",     "dau1_gd0_id", "dau1_gd1_id", "dau1_gd2_id",
+    "dau2_id",     "dau2_gd0_id", "dau2_gd1_id", "dau2_gd2_id"};
+
+typedef map<vector<int>, unsigned long> DecayFreq;
+
+bool decayTruthMatchOk(double q2True, bool isTauDecay, int bMesonId,
+                       int dMesonId) {
+  double q2Min = 100 * 100;
+  if (isTauDecay) q2Min = 1700 * 1700;
+
+  return findIn(LEGAL_B_MESON_IDS, TMath::Abs(bMesonId)) && q2True > q2Min &&
+         isDMeson(TMath::Abs(dMesonId));  // NOTE: Taking abs is crucial!
+}
+
+// Define 'truthmatch' and 'signature'
+RNode defineDecaySignature(RNode df, const string bMeson) {
+  // functions to be JIT'ed, only once per process
+  static bool declared = false;
+  if (!declared) {
+    gInterpreter->Declare(
+        "auto makeVecInt = [](auto...args) { return vector<int>{args...}; };");
+    declared = true;
+  }
+
+  df = defineBranch(df, BRANCH_ALIAES, bMeson);
+  return df
+      .Define("truthmatch", decayTruthMatchOk,
+              {"q2_true", "is_tau", "b_id", "dau0_id"})
+      .Define("signature", "makeVecInt(" +
+                               boost::algorithm::join(DECAY_SIGNATURE, ",") +
+                               ")");
+}
+
+void countDecayFreq(DecayFreq& freq, unsigned long& numOfEvt,
+                    unsigned long& numOfEvtWithB, bool truthMatch,
+                    vector<int> truthSignature) {
+  numOfEvt += 1;
+
+  if (truthMatch) {
+    numOfEvtWithB += 1;
+    vector<int> key = {};
+    for (auto v : truthSignature) key.emplace_back(TMath::Abs(v));
+
+    if (freq.find(key) == freq.end())
+      freq[key] = 1l;
+    else
+      freq[key] += 1;
+  }
+}
+
+// Count decays w/ one 'DecayFreq' per slot, so that it's safe w/ implicit MT
+DecayFreq countDecayFreq(RNode df, unsigned long& numOfEvt,
+                         unsigned long& numOfEvtWithB) {
+  auto nSlots              = df.GetNSlots();
+  auto freqBySlot          = vector<DecayFreq>(nSlots);
+  auto numOfEvtBySlot      = vector<unsigned long>(nSlots, 0);
+  auto numOfEvtWithBBySlot = vector<unsigned long>(nSlots, 0);
+
+  df.ForeachSlot(
+      [&](unsigned int slot, bool truthMatch, vector<int> truthSignature) {
+        countDecayFreq(freqBySlot[slot], numOfEvtBySlot[slot],
+                       numOfEvtWithBBySlot[slot], truthMatch, truthSignature);
+      },
+      {"truthmatch", "signature"});
+
+  auto freq = DecayFreq{};
+  for (unsigned int slot = 0; slot != nSlots; slot++) {
+    for (const auto& [key, val] : freqBySlot[slot]) freq[key] += val;
+    numOfEvt += numOfEvtBySlot[slot];
+    numOfEvtWithB += numOfEvtWithBBySlot[slot];
+  }
+  return freq;
+}
@@ -0,0 +1,127 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+////////////////
+// FF tensors //
+////////////////
+
+// The FFs of BGL-like parameterizations are linear in their coefficients, so
+// the weight of a candidate is a quadratic form in the coefficient shifts
+// 'delta_i' w.r.t. the nominal FF. With x = (1, delta_1, ..., delta_n):
+//   w = sum_{i <= j} c_ij x_i x_j
+// The coefficients c_ij are stored row by row, as the upper triangle.
+
+// The parameters of a decay are the ones varied by its eigenvector variations,
+// in alphabetical order
+vector<string> tensorParams(const vector<map<string, double>>& eigenVars) {
+  auto params = set<string>{};
+  for (const auto& shifts : eigenVars)
+    for (const auto& [param, shift] : shifts) params.insert(param);
+  return vector<string>(params.begin(), params.end());
+}
+
+// A step of the size of the largest eigenvector shift keeps the probes within
+// the physical range of each parameter
+vector<double> tensorSteps(const vector<map<string, double>>& eigenVars) {
+  auto params = tensorParams(eigenVars);
+  auto steps  = vector<double>(params.size(), 0.0);
+  for (size_t idx = 0; idx != params.size(); idx++) {
+    for (const auto& shifts : eigenVars) {
+      auto shift = shifts.find(params[idx]);
+      if (shift != shifts.end())
+        steps[idx] = std::max(steps[idx], std::abs(shift->second));
+    }
+    if (steps[idx] == 0.0) steps[idx] = 1.0;
+  }
+  return steps;
+}
+
+size_t tensorSize(size_t numOfParams) {
+  return (numOfParams + 1) * (numOfParams + 2) / 2;
+}
+
+size_t tensorIdx(size_t i, size_t j, size_t numOfParams) {
+  // i <= j; rows before i have (n + 1) + n + ... + (n + 2 - i) elements
+  return i * (2 * numOfParams + 3 - i) / 2 + (j - i);
+}
+
+template <typename T>
+double evalTensor(const T& coeffs, const vector<double>& x) {
+  double result = 0;
+  size_t idx    = 0;
+  for (size_t i = 0; i != x.size(); i++)
+    for (size_t j = i; j != x.size(); j++)
+      result += coeffs[idx++] * x[i] * x[j];
+  return result;
+}
+
+// x of a parameter point, w/ unspecified parameters at their nominal values
+vector<double> tensorPoint(const vector<string>&      params,
+                           const map<string, double>& point) {
+  auto x = vector<double>(params.size() + 1, 0.0);
+  x[0]   = 1.0;
+  for (const auto& [param, delta] : point) {
+    auto pos = std::find(params.begin(), params.end(), param);
+    if (pos == params.end())
+      throw std::invalid_argument("Unknown FF parameter: " + param);
+    x[pos - params.begin() + 1] = delta;
+  }
+  return x;
+}
+
+//////////////////////
+// Parameter points //
+//////////////////////
+
+struct FFPoint {
+  string              name;
+  string              decay;
+  map<string, double> shifts;
+};
+
+// Each non-empty line of a points file is
+//   <name> <decay> <param>=<delta> <param>=<delta> ...
+// lines starting w/ '#' are ignored
+vector<FFPoint> parseFFPoints(const string filename) {
+  auto result = vector<FFPoint>{};
+  auto input  = std::ifstream(filename);
+  if (!input) throw std::runtime_error("Can't open FF points: " + filename);
+
+  string line;
+  while (getline(input, line)) {
+    auto   buffer = std::stringstream(line);
+    string name, decay, shift;
+    if (!(buffer >> name) || name[0] == '#') continue;
+    if (!(buffer >> decay))
+      throw std::runtime_error("No decay for FF point " + name);
+
+    auto point = FFPoint{name, decay, {}};
+    while (buffer >> shift) {
+      auto eq = shift.find('=');
+      if (eq == string::npos)
+        throw std::runtime_error("Bad shift for FF point " + name + ": " +
+                                 shift);
+      point.shifts[shift.substr(0, eq)] = std::stod(shift.substr(eq + 1));
+    }
+    result.emplace_back(point);
+  }
+
+  return result;
+}
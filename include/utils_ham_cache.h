@@ -0,0 +1,162 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <TSystem.h>
+
+#include <Hammer/Hammer.hh>
+#include <Hammer/IOTypes.hh>
+
+#if __has_include(<Hammer/Config/HammerConfig.hh>)
+#include <Hammer/Config/HammerConfig.hh>
+#endif
+
+using std::string;
+using std::vector;
+
+// The rate buffers are only meaningful to the HAMMER that wrote them. Builds
+// w/o a version macro can pass '-DHAMMER_CACHE_VERSION=...'; otherwise clear
+// the cache after upgrading HAMMER.
+#ifndef HAMMER_CACHE_VERSION
+#ifdef HAMMER_VERSION
+#define HAMMER_CACHE_VERSION HAMMER_VERSION
+#else
+#define HAMMER_CACHE_VERSION "unknown"
+#endif
+#endif
+
+////////////////////
+// Config hashing //
+////////////////////
+
+// FNV-1a, so that the hash is stable across builds and platforms
+uint64_t fnv1a(const string& data, uint64_t hash = 14695981039346656037ull) {
+  for (auto chr : data) {
+    hash ^= static_cast<unsigned char>(chr);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+string readFile(const string path) {
+  std::ifstream file(path, std::ios::binary);
+  return string(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+}
+
+// The option card has all 'setOptions' and FF scheme settings, the header card
+// has the included decays and the FF schemes. Together w/ the HAMMER version,
+// they determine the rates HAMMER integrates.
+// NOTE: Call after configuring the HAMMER, but before 'initRun'
+string hamConfigHash(Hammer::Hammer& ham) {
+  auto prefix = "/tmp/ham-cards-" + std::to_string(getpid());
+  ham.saveOptionCard(prefix + "-options.yml");
+  ham.saveHeaderCard(prefix + "-header.yml");
+
+  auto hash = fnv1a(HAMMER_CACHE_VERSION);
+  hash      = fnv1a(readFile(prefix + "-options.yml"), hash);
+  hash      = fnv1a(readFile(prefix + "-header.yml"), hash);
+  std::remove((prefix + "-options.yml").c_str());
+  std::remove((prefix + "-header.yml").c_str());
+
+  std::ostringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return hex.str();
+}
+
+////////////////
+// Rate cache //
+////////////////
+
+// HAMMER integrates the rates of a process w/ each FF scheme the first time it
+// sees the process, which dominates the startup time. The integrated rates are
+// cached in '<cacheDir>/ham-rates-<hash>.dat', keyed by the configuration hash.
+// The file starts w/ a magic number and the HAMMER version, followed by the
+// record kind, its length and the serialized rates.
+
+const auto RATE_CACHE_MAGIC = string("HAMRATE1");
+
+// 'configHash' as returned by 'hamConfigHash'
+string rateCachePath(const string configHash, const string cacheDir) {
+  gSystem->mkdir(cacheDir.c_str(), true);
+  return cacheDir + "/ham-rates-" + configHash + ".dat";
+}
+
+// NOTE: Call after 'initRun'. Returns false on a cache miss, including a
+//       cache written by another HAMMER version, or a truncated file.
+bool loadRateCache(Hammer::Hammer& ham, const string path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) return false;
+  auto size      = static_cast<uint64_t>(file.tellg());
+  auto remaining = [&] { return size - static_cast<uint64_t>(file.tellg()); };
+  file.seekg(0);
+
+  auto magic = string(RATE_CACHE_MAGIC.size(), '\0');
+  file.read(&magic[0], magic.size());
+  if (!file || magic != RATE_CACHE_MAGIC) return false;
+
+  uint32_t verLength;
+  file.read(reinterpret_cast<char*>(&verLength), sizeof(verLength));
+  if (!file || verLength > remaining()) return false;
+  auto version = string(verLength, '\0');
+  file.read(&version[0], verLength);
+  if (!file || version != HAMMER_CACHE_VERSION) return false;
+
+  uint8_t  kind;
+  uint32_t length;
+  file.read(reinterpret_cast<char*>(&kind), sizeof(kind));
+  file.read(reinterpret_cast<char*>(&length), sizeof(length));
+  // the record must fill the rest of the file exactly
+  if (!file || length != remaining()) return false;
+
+  auto data = vector<uint8_t>(length);
+  file.read(reinterpret_cast<char*>(data.data()), length);
+  if (!file) return false;
+
+  auto buf = Hammer::IOBuffer{static_cast<Hammer::RecordType>(kind), length,
+                              data.data()};
+  return ham.loadRates(buf);
+}
+
+// Written to a temporary file first, so that concurrent jobs sharing the cache
+// never see a partial file
+void saveRateCache(Hammer::Hammer& ham, const string path) {
+  auto buf = ham.saveRates();
+  auto tmp = path + "." + std::to_string(getpid()) + ".tmp";
+
+  std::ofstream file(tmp, std::ios::binary);
+  auto          version   = string(HAMMER_CACHE_VERSION);
+  auto          verLength = static_cast<uint32_t>(version.size());
+  auto          kind      = static_cast<uint8_t>(buf.kind);
+  file.write(RATE_CACHE_MAGIC.data(), RATE_CACHE_MAGIC.size());
+  file.write(reinterpret_cast<const char*>(&verLength), sizeof(verLength));
+  file.write(version.data(), verLength);
+  file.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+  file.write(reinterpret_cast<const char*>(&buf.length), sizeof(buf.length));
+  file.write(reinterpret_cast<const char*>(buf.start), buf.length);
+  file.close();
+
+  if (file)
+    std::rename(tmp.c_str(), path.c_str());
+  else
+    std::remove(tmp.c_str());
+}
+
+// Rates are integrated lazily in each HAMMER, so merge them before saving
+void saveRateCache(const vector<Hammer::Hammer*>& hams, const string path) {
+  for (size_t idx = 1; idx < hams.size(); idx++)
+    hams[0]->loadRates(hams[idx]->saveRates(), true);
+  saveRateCache(*hams[0], path);
+}
@@ -0,0 +1,289 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+///////////////
+// Idle wait //
+///////////////
+
+// Lets idle threads sleep on a condition variable until a condition, made true
+// by other threads, holds. The notifying side only takes the lock when someone
+// is waiting, so the lock-free fast paths stay lock-free.
+class IdleWait {
+ public:
+  template <typename Pred>
+  void wait(Pred pred);
+
+  void notifyOne();
+  void notifyAll();
+
+ private:
+  std::mutex              mtx;
+  std::condition_variable cv;
+  std::atomic<size_t>     numOfWaiters{0};
+};
+
+template <typename Pred>
+void IdleWait::wait(Pred pred) {
+  std::unique_lock<std::mutex> lock(mtx);
+  numOfWaiters++;
+  // pairs w/ the fence in 'notify*': either the waiter sees the new state, or
+  // the notifier sees the waiter
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  cv.wait(lock, pred);
+  numOfWaiters--;
+}
+
+inline void IdleWait::notifyOne() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (numOfWaiters.load(std::memory_order_relaxed) == 0) return;
+  std::lock_guard<std::mutex> lock(mtx);
+  cv.notify_one();
+}
+
+inline void IdleWait::notifyAll() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (numOfWaiters.load(std::memory_order_relaxed) == 0) return;
+  std::lock_guard<std::mutex> lock(mtx);
+  cv.notify_all();
+}
+
+///////////////////
+// Bounded queue //
+///////////////////
+
+// A bounded multi-producer, multi-consumer lock-free queue, after D. Vyukov.
+// 'push' sleeps when the queue is full, which provides backpressure to the
+// producers; 'pop' sleeps when it's empty and returns false once the queue is
+// closed and drained.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity);
+
+  bool tryPush(T& item);
+  bool tryPop(T& item);
+
+  void push(T item);
+  bool pop(T& item);
+  void close();
+
+ private:
+  struct Cell {
+    std::atomic<size_t> seq;
+    T                   data;
+  };
+
+  static size_t roundUpPow2(size_t num);
+
+  size_t                  mask;
+  std::unique_ptr<Cell[]> cells;
+
+  alignas(64) std::atomic<size_t> enqueuePos{0};
+  alignas(64) std::atomic<size_t> dequeuePos{0};
+  alignas(64) std::atomic<bool> closed{false};
+
+  IdleWait notFull;
+  IdleWait notEmpty;
+};
+
+template <typename T>
+size_t BoundedQueue<T>::roundUpPow2(size_t num) {
+  size_t result = 2;
+  while (result < num) result <<= 1;
+  return result;
+}
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+    : mask(roundUpPow2(capacity) - 1), cells(new Cell[mask + 1]) {
+  for (size_t idx = 0; idx <= mask; idx++)
+    cells[idx].seq.store(idx, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool BoundedQueue<T>::tryPush(T& item) {
+  auto pos = enqueuePos.load(std::memory_order_relaxed);
+  for (;;) {
+    auto& cell = cells[pos & mask];
+    auto  seq  = cell.seq.load(std::memory_order_acquire);
+    auto  diff = static_cast<std::ptrdiff_t>(seq) -
+                static_cast<std::ptrdiff_t>(pos);
+
+    if (diff == 0) {
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+        cell.data = std::move(item);
+        cell.seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;  // full
+    } else {
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T>
+bool BoundedQueue<T>::tryPop(T& item) {
+  auto pos = dequeuePos.load(std::memory_order_relaxed);
+  for (;;) {
+    auto& cell = cells[pos & mask];
+    auto  seq  = cell.seq.load(std::memory_order_acquire);
+    auto  diff = static_cast<std::ptrdiff_t>(seq) -
+                static_cast<std::ptrdiff_t>(pos + 1);
+
+    if (diff == 0) {
+      if (dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+        item = std::move(cell.data);
+        cell.seq.store(pos + mask + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;  // empty
+    } else {
+      pos = dequeuePos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T>
+void BoundedQueue<T>::push(T item) {
+  if (!tryPush(item)) notFull.wait([&] { return tryPush(item); });
+  notEmpty.notifyOne();
+}
+
+template <typename T>
+bool BoundedQueue<T>::pop(T& item) {
+  for (;;) {
+    if (tryPop(item)) break;
+    // everything pushed before closing must still be drained
+    if (closed.load(std::memory_order_acquire)) {
+      if (tryPop(item)) break;
+      return false;
+    }
+
+    auto ok = false;
+    notEmpty.wait([&] {
+      return (ok = tryPop(item)) || closed.load(std::memory_order_acquire);
+    });
+    if (ok) break;
+  }
+  notFull.notifyOne();
+  return true;
+}
+
+template <typename T>
+void BoundedQueue<T>::close() {
+  closed.store(true, std::memory_order_release);
+  notEmpty.notifyAll();
+}
+
+///////////////////
+// Work stealing //
+///////////////////
+
+// Per-worker task deques. The producer deals tasks round-robin to the back of
+// the deques; a worker takes the oldest task from the front of its own deque
+// and, once that's empty, steals the newest task from the back of another one.
+// Idle workers sleep until a task is pushed; 'pop' returns false once closed and
+// all deques are drained.
+template <typename T>
+class WorkStealingDeques {
+ public:
+  explicit WorkStealingDeques(size_t numOfWorkers);
+
+  void push(T task);
+  bool pop(size_t worker, T& task);
+  void close();
+
+ private:
+  struct alignas(64) Deque {
+    std::mutex    mtx;
+    std::deque<T> tasks;
+  };
+
+  bool tryPopFront(size_t worker, T& task);
+  bool trySteal(size_t worker, T& task);
+
+  size_t                   numOfWorkers;
+  std::unique_ptr<Deque[]> deques;
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool>   closed{false};
+
+  IdleWait idle;
+};
+
+template <typename T>
+WorkStealingDeques<T>::WorkStealingDeques(size_t numOfWorkers)
+    : numOfWorkers(numOfWorkers), deques(new Deque[numOfWorkers]) {}
+
+template <typename T>
+void WorkStealingDeques<T>::push(T task) {
+  auto& deque = deques[next++ % numOfWorkers];
+  {
+    std::lock_guard<std::mutex> lock(deque.mtx);
+    deque.tasks.emplace_back(std::move(task));
+  }
+  idle.notifyOne();
+}
+
+template <typename T>
+bool WorkStealingDeques<T>::tryPopFront(size_t worker, T& task) {
+  auto&                       deque = deques[worker];
+  std::lock_guard<std::mutex> lock(deque.mtx);
+  if (deque.tasks.empty()) return false;
+
+  task = std::move(deque.tasks.front());
+  deque.tasks.pop_front();
+  return true;
+}
+
+template <typename T>
+bool WorkStealingDeques<T>::trySteal(size_t worker, T& task) {
+  for (size_t offset = 1; offset < numOfWorkers; offset++) {
+    auto& victim = deques[(worker + offset) % numOfWorkers];
+    std::lock_guard<std::mutex> lock(victim.mtx);
+    if (victim.tasks.empty()) continue;
+
+    task = std::move(victim.tasks.back());
+    victim.tasks.pop_back();
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+bool WorkStealingDeques<T>::pop(size_t worker, T& task) {
+  for (;;) {
+    if (tryPopFront(worker, task) || trySteal(worker, task)) return true;
+    // everything pushed before closing must still be drained
+    if (closed.load(std::memory_order_acquire))
+      return tryPopFront(worker, task) || trySteal(worker, task);
+
+    auto ok = false;
+    idle.wait([&] {
+      return (ok = tryPopFront(worker, task) || trySteal(worker, task)) ||
+             closed.load(std::memory_order_acquire);
+    });
+    if (ok) return true;
+  }
+}
+
+template <typename T>
+void WorkStealingDeques<T>::close() {
+  closed.store(true, std::memory_order_release);
+  idle.notifyAll();
+}
@@ -0,0 +1,219 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <TChain.h>
+#include <TFile.h>
+#include <TParameter.h>
+#include <TTree.h>
+
+#include "utils_general.h"
+#include "utils_weight_sums.h"
+
+using std::pair;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+//////////////////
+// Entry ranges //
+//////////////////
+
+// [first, last), as in RDataFrame::Range
+typedef pair<Long64_t, Long64_t> EntryRange;
+
+Long64_t getEntries(const string ntp, const string tree) {
+  auto file = unique_ptr<TFile>(TFile::Open(ntp.c_str()));
+  if (!file || file->IsZombie())
+    throw std::runtime_error("Can't open ntuple: " + ntp);
+
+  auto ntpTree = file->Get<TTree>(tree.c_str());
+  if (ntpTree == nullptr)
+    throw std::runtime_error("Can't find tree " + tree + " in " + ntp);
+
+  return ntpTree->GetEntries();
+}
+
+// First entries of the clusters of the tree, which the event loop tasks never
+// split
+vector<Long64_t> clusterStarts(const string ntp, const string tree) {
+  auto file = unique_ptr<TFile>(TFile::Open(ntp.c_str()));
+  if (!file || file->IsZombie())
+    throw std::runtime_error("Can't open ntuple: " + ntp);
+
+  auto ntpTree = file->Get<TTree>(tree.c_str());
+  if (ntpTree == nullptr)
+    throw std::runtime_error("Can't find tree " + tree + " in " + ntp);
+
+  auto     result  = vector<Long64_t>{};
+  auto     cluster = ntpTree->GetClusterIterator(0);
+  Long64_t start;
+  while ((start = cluster()) < ntpTree->GetEntries())
+    result.emplace_back(start);
+  return result;
+}
+
+EntryRange shardRange(EntryRange range, unsigned int idx, unsigned int num) {
+  auto [first, last] = range;
+  auto size          = last - first;
+  return {first + size * idx / num, first + size * (idx + 1) / num};
+}
+
+// Shards are specified as 'i/n', with 0 <= i < n
+pair<unsigned int, unsigned int> parseShard(const string shard) {
+  auto splitted = split(shard, '/');
+  if (splitted.size() != 2)
+    throw std::invalid_argument("Shard must be in the form of i/n: " + shard);
+
+  auto idx = static_cast<unsigned int>(std::stoul(splitted[0]));
+  auto num = static_cast<unsigned int>(std::stoul(splitted[1]));
+  if (num == 0 || idx >= num)
+    throw std::invalid_argument("Shard index out of range: " + shard);
+
+  return {idx, num};
+}
+
+////////////////////////
+// Entry range labels //
+////////////////////////
+
+// The entry range of a (partial) output tree is stored next to the tree, as
+// '<tree>_first_entry' and '<tree>_last_entry'
+
+void writeEntryRange(TFile* file, const string tree, EntryRange range) {
+  auto prefix = string(basename(tree));
+  file->cd(dirname(tree));
+
+  TParameter<Long64_t>((prefix + "_first_entry").c_str(), range.first)
+      .Write(nullptr, TObject::kOverwrite);
+  TParameter<Long64_t>((prefix + "_last_entry").c_str(), range.second)
+      .Write(nullptr, TObject::kOverwrite);
+}
+
+void writeEntryRange(const string ntp, const string tree, EntryRange range) {
+  auto file = unique_ptr<TFile>(TFile::Open(ntp.c_str(), "UPDATE"));
+  writeEntryRange(file.get(), tree, range);
+}
+
+EntryRange readEntryRange(const string ntp, const string tree) {
+  auto file = unique_ptr<TFile>(TFile::Open(ntp.c_str()));
+  if (!file || file->IsZombie())
+    throw std::runtime_error("Can't open ntuple: " + ntp);
+
+  auto first = file->Get<TParameter<Long64_t>>((tree + "_first_entry").c_str());
+  auto last  = file->Get<TParameter<Long64_t>>((tree + "_last_entry").c_str());
+
+  if (first == nullptr || last == nullptr)
+    throw std::runtime_error("No entry range for " + tree + " in " + ntp);
+
+  return {first->GetVal(), last->GetVal()};
+}
+
+/////////////
+// Merging //
+/////////////
+
+// Concatenate a tree from partial outputs, in the order of 'ntpParts', into an
+// already opened output file
+void copyTree(TFile* outputFile, const vector<string>& ntpParts,
+              const string tree) {
+  TChain chain(tree.c_str());
+  for (const auto& part : ntpParts) chain.Add(part.c_str());
+
+  auto dir = dirname(tree);
+  if (dir != "" && !outputFile->GetDirectory(dir)) outputFile->mkdir(dir);
+  outputFile->cd(dir);
+
+  auto merged = chain.CloneTree(-1, "fast");
+  merged->SetName(basename(tree));
+  merged->Write(nullptr, TObject::kOverwrite);
+}
+
+// Copy a tree into an already opened output file, sorted by the input entry
+// numbers in 'entryBr', which is dropped from the copy
+void copyTreeInEntryOrder(TFile* outputFile, const string ntpPart,
+                          const string tree, const string entryBr) {
+  auto inputFile = unique_ptr<TFile>(TFile::Open(ntpPart.c_str()));
+  if (!inputFile || inputFile->IsZombie())
+    throw std::runtime_error("Can't open ntuple: " + ntpPart);
+  auto input = inputFile->Get<TTree>(tree.c_str());
+  if (input == nullptr)
+    throw std::runtime_error("Can't find tree " + tree + " in " + ntpPart);
+
+  ULong64_t entry;
+  input->SetBranchStatus("*", false);
+  input->SetBranchStatus(entryBr.c_str(), true);
+  input->SetBranchAddress(entryBr.c_str(), &entry);
+
+  auto order = vector<pair<ULong64_t, Long64_t>>(input->GetEntries());
+  for (Long64_t idx = 0; idx != input->GetEntries(); idx++) {
+    input->GetEntry(idx);
+    order[idx] = {entry, idx};
+  }
+  std::sort(order.begin(), order.end());
+
+  input->ResetBranchAddresses();
+  input->SetBranchStatus("*", true);
+  input->SetBranchStatus(entryBr.c_str(), false);
+
+  auto dir = dirname(tree);
+  if (dir != "" && !outputFile->GetDirectory(dir)) outputFile->mkdir(dir);
+  outputFile->cd(dir);
+
+  auto sorted = input->CloneTree(0);
+  sorted->SetName(basename(tree));
+  for (const auto& [inputEntry, idx] : order) {
+    input->GetEntry(idx);
+    sorted->Fill();
+  }
+  sorted->Write(nullptr, TObject::kOverwrite);
+}
+
+// Concatenate partial outputs of each tree in input entry order. The partial
+// outputs must cover a contiguous entry range w/o gaps or overlaps.
+void mergeShards(const vector<string>& ntpParts, const string ntpOut,
+                 const vector<string>& trees) {
+  auto outputFile = unique_ptr<TFile>(TFile::Open(ntpOut.c_str(), "UPDATE"));
+
+  for (const auto& tree : trees) {
+    auto shards = vector<pair<EntryRange, string>>{};
+    for (const auto& part : ntpParts)
+      shards.emplace_back(readEntryRange(part, tree), part);
+    std::sort(shards.begin(), shards.end());
+
+    for (size_t idx = 1; idx < shards.size(); idx++) {
+      if (shards[idx].first.first != shards[idx - 1].first.second)
+        throw std::runtime_error("Shards of " + tree + " are not contiguous: " +
+                                 shards[idx - 1].second + " and " +
+                                 shards[idx].second);
+    }
+
+    auto sortedParts = vector<string>{};
+    for (const auto& [range, part] : shards) sortedParts.emplace_back(part);
+    copyTree(outputFile.get(), sortedParts, tree);
+
+    writeEntryRange(outputFile.get(), tree,
+                    {shards.front().first.first, shards.back().first.second});
+
+    // merged in entry order, so that the sums don't depend on the file order
+    auto weightNames = vector<string>{};
+    auto sums        = WeightSumsByMode{};
+    bool allSums     = true;
+    for (const auto& part : sortedParts) {
+      auto partNames = vector<string>{};
+      auto partSums  = WeightSumsByMode{};
+      allSums = allSums && readWeightSums(part, tree, partNames, partSums);
+      if (!partNames.empty()) weightNames = partNames;
+      mergeWeightSums(sums, partSums);
+    }
+    if (allSums) writeWeightSums(outputFile.get(), tree, weightNames, sums);
+  }
+}
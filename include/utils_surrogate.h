@@ -0,0 +1,263 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <TFile.h>
+#include <TMath.h>
+#include <TTree.h>
+
+using std::array;
+using std::map;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+////////////////////
+// Surrogate grid //
+////////////////////
+
+// A regular grid over (q2 [GeV^2], cos theta_l, cos theta_V, chi), w/ the
+// weights of all variants at each node, as computed by HAMMER for an event w/
+// the kinematics of the node. In between, the weights are interpolated
+// multilinearly.
+
+struct GridAxis {
+  double min;
+  double max;
+  size_t numOfNodes;
+};
+
+// q2, cos theta_l, cos theta_V, chi
+const auto SURROGATE_AXES =
+    array<GridAxis, 4>{{{0.0, 12.0, 17},
+                        {-1.0, 1.0, 9},
+                        {-1.0, 1.0, 9},
+                        {-TMath::Pi(), TMath::Pi(), 9}}};
+
+typedef array<double, 4> GridVars;
+
+class SurrogateGrid {
+ public:
+  explicit SurrogateGrid(size_t numOfWeights = 0);
+
+  static size_t   numOfNodes();
+  static GridVars nodeVars(size_t node);
+
+  // Nodes w/o weights (e.g. where HAMMER failed) are skipped by 'eval'
+  void set(size_t node, const vector<double>& weights);
+
+  // Returns an empty vector if all surrounding nodes are empty
+  vector<double> eval(const GridVars& vars) const;
+  // The weights of the i-th point are at [i * numOfWeights, (i + 1) *
+  // numOfWeights) of 'result'; 'ok' is false where all surrounding nodes are
+  // empty
+  void evalBatch(const vector<GridVars>& vars, vector<double>& result,
+                 vector<char>& ok) const;
+
+  size_t         numOfWeights;
+  vector<double> values;  // by node, then by weight
+  vector<char>   filled;  // by node
+
+ private:
+  array<std::pair<size_t, double>, 16> corners(const GridVars& vars) const;
+};
+
+SurrogateGrid::SurrogateGrid(size_t numOfWeights)
+    : numOfWeights(numOfWeights),
+      values(numOfNodes() * numOfWeights, 0.0),
+      filled(numOfNodes(), false) {}
+
+size_t SurrogateGrid::numOfNodes() {
+  size_t result = 1;
+  for (const auto& axis : SURROGATE_AXES) result *= axis.numOfNodes;
+  return result;
+}
+
+// Nodes are numbered row-major, w/ q2 the slowest
+GridVars SurrogateGrid::nodeVars(size_t node) {
+  auto result = GridVars{};
+  for (size_t dim = 4; dim-- != 0;) {
+    const auto& axis = SURROGATE_AXES[dim];
+    auto        idx  = node % axis.numOfNodes;
+    node /= axis.numOfNodes;
+    result[dim] =
+        axis.min + (axis.max - axis.min) * idx / (axis.numOfNodes - 1);
+  }
+  return result;
+}
+
+// Out-of-range values are clamped to the edges of the grid
+array<std::pair<size_t, double>, 16> SurrogateGrid::corners(
+    const GridVars& vars) const {
+  auto lower = array<size_t, 4>{};
+  auto frac  = array<double, 4>{};
+  for (size_t dim = 0; dim != 4; dim++) {
+    const auto& axis = SURROGATE_AXES[dim];
+    auto        pos  = (vars[dim] - axis.min) / (axis.max - axis.min) *
+                   static_cast<double>(axis.numOfNodes - 1);
+    pos        = std::min(std::max(pos, 0.0), axis.numOfNodes - 1.0);
+    lower[dim] = std::min(static_cast<size_t>(pos), axis.numOfNodes - 2);
+    frac[dim]  = pos - lower[dim];
+  }
+
+  auto result = array<std::pair<size_t, double>, 16>{};
+  for (size_t corner = 0; corner != 16; corner++) {
+    size_t idx   = 0;
+    double coeff = 1.0;
+    for (size_t dim = 0; dim != 4; dim++) {
+      auto upper = (corner >> dim) & 1;
+      idx        = idx * SURROGATE_AXES[dim].numOfNodes + lower[dim] + upper;
+      coeff     *= upper ? frac[dim] : 1.0 - frac[dim];
+    }
+    result[corner] = {idx, coeff};
+  }
+  return result;
+}
+
+void SurrogateGrid::set(size_t node, const vector<double>& weights) {
+  std::copy(weights.begin(), weights.end(),
+            values.begin() + node * numOfWeights);
+  filled[node] = true;
+}
+
+// Empty nodes are skipped, and the coefficients of the others renormalized
+void SurrogateGrid::evalBatch(const vector<GridVars>& vars,
+                              vector<double>& result, vector<char>& ok) const {
+  result.assign(vars.size() * numOfWeights, 0.0);
+  ok.assign(vars.size(), false);
+
+  for (size_t pt = 0; pt != vars.size(); pt++) {
+    auto   out  = result.data() + pt * numOfWeights;
+    double norm = 0.0;
+    for (const auto& [node, coeff] : corners(vars[pt])) {
+      if (!filled[node] || coeff == 0.0) continue;
+      norm += coeff;
+      auto val = values.data() + node * numOfWeights;
+      for (size_t idx = 0; idx != numOfWeights; idx++)
+        out[idx] += coeff * val[idx];
+    }
+
+    if (norm == 0.0) continue;
+    ok[pt] = true;
+    for (size_t idx = 0; idx != numOfWeights; idx++) out[idx] /= norm;
+  }
+}
+
+vector<double> SurrogateGrid::eval(const GridVars& vars) const {
+  auto result = vector<double>{};
+  auto ok     = vector<char>{};
+  evalBatch({vars}, result, ok);
+  if (!ok[0]) return {};
+  return result;
+}
+
+/////////////////////
+// Surrogate table //
+/////////////////////
+
+// One grid per decay mode, e.g. 'BD*MuNu_511_413_421_211' (see
+// 'surrogateMode')
+typedef map<string, SurrogateGrid> SurrogateTable;
+
+// The table is stored w/ the HAMMER configuration hash and the names of the
+// variants it's computed for, so that it's never applied to other weights
+void saveSurrogateTable(const SurrogateTable& table, const string filename,
+                        const string          configHash,
+                        const vector<string>& variantNames) {
+  auto file = unique_ptr<TFile>(TFile::Open(filename.c_str(), "RECREATE"));
+
+  auto configTree = new TTree("surrogate_config", "surrogate_config");
+  auto hash       = configHash;
+  auto names      = variantNames;
+  configTree->Branch("config_hash", &hash);
+  configTree->Branch("variants", &names);
+  configTree->Fill();
+  configTree->Write();
+
+  auto tree = new TTree("surrogate", "surrogate");
+
+  string         mode;
+  vector<double> values;
+  vector<char>   filled;
+  tree->Branch("mode", &mode);
+  tree->Branch("values", &values);
+  tree->Branch("filled", &filled);
+  for (const auto& [key, grid] : table) {
+    mode   = key;
+    values = grid.values;
+    filled = grid.filled;
+    tree->Fill();
+  }
+
+  tree->Write();
+  file->Close();
+}
+
+SurrogateTable loadSurrogateTable(const string filename, size_t numOfWeights,
+                                  const string          configHash,
+                                  const vector<string>& variantNames) {
+  auto file = unique_ptr<TFile>(TFile::Open(filename.c_str()));
+  if (!file || file->IsZombie())
+    throw std::runtime_error("Can't open surrogate table: " + filename);
+  auto configTree = file->Get<TTree>("surrogate_config");
+  auto tree       = file->Get<TTree>("surrogate");
+  if (configTree == nullptr || tree == nullptr)
+    throw std::runtime_error("No surrogate table in " + filename);
+
+  string         hash;
+  vector<string> names;
+  auto           hashPtr  = &hash;
+  auto           namesPtr = &names;
+  configTree->SetBranchAddress("config_hash", &hashPtr);
+  configTree->SetBranchAddress("variants", &namesPtr);
+  if (configTree->GetEntries() != 1)
+    throw std::runtime_error("No surrogate table in " + filename);
+  configTree->GetEntry(0);
+  if (hash != configHash)
+    throw std::runtime_error("Surrogate table " + filename +
+                             " is computed w/ another HAMMER configuration");
+  if (names != variantNames)
+    throw std::runtime_error("Surrogate table " + filename +
+                             " is computed for other variants");
+
+  if (tree->GetBranch("values") == nullptr ||
+      tree->GetBranch("filled") == nullptr)
+    throw std::runtime_error("Surrogate table " + filename +
+                             " is in an outdated format");
+
+  string         mode;
+  vector<double> values;
+  vector<char>   filled;
+  auto           modePtr   = &mode;
+  auto           valuesPtr = &values;
+  auto           filledPtr = &filled;
+  tree->SetBranchAddress("mode", &modePtr);
+  tree->SetBranchAddress("values", &valuesPtr);
+  tree->SetBranchAddress("filled", &filledPtr);
+
+  auto table = SurrogateTable{};
+  for (Long64_t entry = 0; entry != tree->GetEntries(); entry++) {
+    tree->GetEntry(entry);
+    auto grid = SurrogateGrid(numOfWeights);
+    if (values.size() != grid.values.size() ||
+        filled.size() != grid.filled.size())
+      throw std::runtime_error("Surrogate table " + filename +
+                               " doesn't match the grid or variants");
+    grid.values = values;
+    grid.filled = filled;
+    table.emplace(mode, grid);
+  }
+
+  return table;
+}
@@ -0,0 +1,173 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#pragma once
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <TFile.h>
+#include <TMath.h>
+#include <TTree.h>
+
+#include "utils_general.h"
+
+using std::map;
+using std::pair;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+//////////////////////
+// Compensated sums //
+//////////////////////
+
+// Neumaier's variant of Kahan summation, which also compensates when a term is
+// larger than the running sum
+struct KahanSum {
+  double sum  = 0.0;
+  double comp = 0.0;
+
+  void add(double val) {
+    auto total = sum + val;
+    if (TMath::Abs(sum) >= TMath::Abs(val))
+      comp += (sum - total) + val;
+    else
+      comp += (val - total) + sum;
+    sum = total;
+  }
+
+  double value() const { return sum + comp; }
+};
+
+/////////////////
+// Weight sums //
+/////////////////
+
+// Sum of weights and of squared weights of each weight branch, by decay mode
+// ('d_meson1_true_id', 'is_tau'). The NaN weights of failed FF variations are
+// left out.
+
+typedef pair<int, bool> DecayModeKey;
+
+struct WeightSums {
+  unsigned long    numOfCand = 0;
+  vector<KahanSum> sumW{};
+  vector<KahanSum> sumW2{};
+
+  void add(const vector<double>& weights) {
+    if (sumW.empty()) {
+      sumW  = vector<KahanSum>(weights.size());
+      sumW2 = vector<KahanSum>(weights.size());
+    }
+    numOfCand += 1;
+    for (size_t idx = 0; idx != weights.size(); idx++) {
+      if (std::isnan(weights[idx])) continue;
+      sumW[idx].add(weights[idx]);
+      sumW2[idx].add(weights[idx] * weights[idx]);
+    }
+  }
+
+  void merge(const WeightSums& other) {
+    if (sumW.empty()) {
+      sumW  = vector<KahanSum>(other.sumW.size());
+      sumW2 = vector<KahanSum>(other.sumW2.size());
+    }
+    numOfCand += other.numOfCand;
+    for (size_t idx = 0; idx != other.sumW.size(); idx++) {
+      sumW[idx].add(other.sumW[idx].value());
+      sumW2[idx].add(other.sumW2[idx].value());
+    }
+  }
+};
+
+typedef map<DecayModeKey, WeightSums> WeightSumsByMode;
+
+void mergeWeightSums(WeightSumsByMode& sums, const WeightSumsByMode& other) {
+  for (const auto& [mode, modeSums] : other) sums[mode].merge(modeSums);
+}
+
+// Stored next to the tree as '<tree>_weight_sums', w/ one entry per decay mode
+// and weight branch
+void writeWeightSums(TFile* file, const string tree,
+                     const vector<string>&   weightNames,
+                     const WeightSumsByMode& sums) {
+  auto dir = dirname(tree);
+  if (dir != "" && !file->GetDirectory(dir)) file->mkdir(dir);
+  file->cd(dir);
+
+  auto name    = string(basename(tree)) + "_weight_sums";
+  auto sumTree = new TTree(name.c_str(), name.c_str());
+
+  int       dMesonId;
+  bool      isTau;
+  string    weight;
+  ULong64_t numOfCand;
+  double    sumW, sumW2;
+  sumTree->Branch("d_meson1_true_id", &dMesonId);
+  sumTree->Branch("is_tau", &isTau);
+  sumTree->Branch("weight", &weight);
+  sumTree->Branch("num_of_cand", &numOfCand);
+  sumTree->Branch("sum_w", &sumW);
+  sumTree->Branch("sum_w2", &sumW2);
+
+  for (const auto& [mode, modeSums] : sums) {
+    std::tie(dMesonId, isTau) = mode;
+    numOfCand                 = modeSums.numOfCand;
+    for (size_t idx = 0; idx != modeSums.sumW.size(); idx++) {
+      weight = weightNames[idx];
+      sumW   = modeSums.sumW[idx].value();
+      sumW2  = modeSums.sumW2[idx].value();
+      sumTree->Fill();
+    }
+  }
+
+  sumTree->Write(nullptr, TObject::kOverwrite);
+}
+
+void writeWeightSums(const string ntp, const string tree,
+                     const vector<string>&   weightNames,
+                     const WeightSumsByMode& sums) {
+  auto file = unique_ptr<TFile>(TFile::Open(ntp.c_str(), "UPDATE"));
+  writeWeightSums(file.get(), tree, weightNames, sums);
+}
+
+// Returns false if there are no weight sums for the tree
+bool readWeightSums(const string ntp, const string tree,
+                    vector<string>& weightNames, WeightSumsByMode& sums) {
+  auto file    = unique_ptr<TFile>(TFile::Open(ntp.c_str()));
+  auto sumTree = file->Get<TTree>((tree + "_weight_sums").c_str());
+  if (sumTree == nullptr) return false;
+
+  int       dMesonId;
+  bool      isTau;
+  string    weight;
+  ULong64_t numOfCand;
+  double    sumW, sumW2;
+  auto      weightPtr = &weight;
+  sumTree->SetBranchAddress("d_meson1_true_id", &dMesonId);
+  sumTree->SetBranchAddress("is_tau", &isTau);
+  sumTree->SetBranchAddress("weight", &weightPtr);
+  sumTree->SetBranchAddress("num_of_cand", &numOfCand);
+  sumTree->SetBranchAddress("sum_w", &sumW);
+  sumTree->SetBranchAddress("sum_w2", &sumW2);
+
+  weightNames.clear();
+  sums.clear();
+  for (Long64_t entry = 0; entry != sumTree->GetEntries(); entry++) {
+    sumTree->GetEntry(entry);
+    auto& modeSums = sums[{dMesonId, isTau}];
+    if (modeSums.sumW.empty()) modeSums.numOfCand = numOfCand;
+    modeSums.sumW.emplace_back(KahanSum{sumW, 0.0});
+    modeSums.sumW2.emplace_back(KahanSum{sumW2, 0.0});
+    if (sums.size() == 1) weightNames.emplace_back(weight);
+  }
+
+  return true;
+}
@@ -0,0 +1,130 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <TString.h>
+#include <ROOT/RDataFrame.hxx>
+#include <ROOT/RVec.hxx>
+
+#include <cxxopts.hpp>
+
+#include "ff_params_nominal.h"
+#include "utils_ff_tensor.h"
+#include "utils_general.h"
+
+using namespace std;
+using namespace std::chrono;
+using ROOT::RDataFrame;
+using ROOT::RDF::RNode;
+using ROOT::VecOps::RVec;
+
+////////////////
+// Evaluation //
+////////////////
+
+// Candidates of other decays, or w/o a FF tensor, keep their nominal weight
+RNode defineFFPoint(RNode df, const FFPoint& point, const string nominalBr,
+                    const string tensorBr) {
+  auto eigenVars = ffNominal::ffEigenVarSpecs.find(point.decay);
+  if (eigenVars == ffNominal::ffEigenVarSpecs.end())
+    throw invalid_argument("No FF tensor for decay " + point.decay +
+                           " of FF point " + point.name);
+
+  auto x     = tensorPoint(tensorParams(eigenVars->second), point.shifts);
+  auto decay = point.decay;
+  return df.Define(
+      point.name,
+      [x, decay](double wff, const RVec<double>& tensor,
+                 const string& tensorDecay) {
+        if (tensor.empty() || tensorDecay != decay) return wff;
+        return evalTensor(tensor, x);
+      },
+      {nominalBr, tensorBr, tensorBr + "_decay"});
+}
+
+void evalTree(const string ntpIn, const string ntpOut, const string tree,
+              const vector<FFPoint>& points, const string nominalBr,
+              const string tensorBr) {
+  RNode df        = static_cast<RNode>(RDataFrame(tree, ntpIn));
+  auto  outputBrs = vector<string>{"runNumber", "eventNumber"};
+
+  for (const auto& point : points) {
+    df = defineFFPoint(df, point, nominalBr, tensorBr);
+    outputBrs.emplace_back(point.name);
+  }
+
+  auto writeOpts  = ROOT::RDF::RSnapshotOptions{};
+  writeOpts.fMode = "UPDATE";
+
+  auto start    = high_resolution_clock::now();
+  auto numOfEvt = df.Count();
+  df.Snapshot(tree, ntpOut, outputBrs, writeOpts);
+  auto stop = high_resolution_clock::now();
+
+  cout << "Evaluated " << points.size() << " FF points for " << *numOfEvt
+       << " candidates of " << tree << " in "
+       << duration_cast<milliseconds>(stop - start).count() << " ms" << endl;
+}
+
+//////////
+// Main //
+//////////
+
+int main(int argc, char** argv) {
+  cxxopts::Options argOpts("EvalFFTensor",
+                           "evaluate weights of FF points w/ FF tensors.");
+
+  // clang-format off
+  argOpts.add_options()
+    // positional
+    ("ntpIn", "specify ReweightRDX output w/ FF tensors.",
+     cxxopts::value<string>())
+    ("ntpOut", "specify output ntuple.", cxxopts::value<string>())
+    ("extra", "unused.", cxxopts::value<vector<string>>())
+    // keyword
+    ("h,help", "print help.")
+    ("t,trees", "specify tree name.",
+     cxxopts::value<vector<string>>()
+     ->default_value("TupleBminus/DecayTree,TupleB0/DecayTree"))
+    ("p,points", "specify a file of FF points.", cxxopts::value<string>())
+    ("n,nominal", "specify nominal weight branch.",
+     cxxopts::value<string>()->default_value("wff"))
+    ("tensor", "specify FF tensor branch.",
+     cxxopts::value<string>()->default_value("wff_tensor"))
+  ;
+  // setup positional argument
+  argOpts.parse_positional({"ntpIn", "ntpOut", "extra"});
+  // clang-format on
+
+  auto parsedArgs = argOpts.parse(argc, argv);
+  if (parsedArgs.count("help")) {
+    cout << argOpts.help() << endl;
+    return 0;
+  }
+  if (!parsedArgs.count("ntpOut") || !parsedArgs.count("points")) {
+    cout << "ERROR: Both an output ntuple and a points file are required."
+         << endl;
+    cout << argOpts.help() << endl;
+    return 1;
+  }
+
+  auto ntpIn     = parsedArgs["ntpIn"].as<string>();
+  auto ntpOut    = parsedArgs["ntpOut"].as<string>();
+  auto trees     = parsedArgs["trees"].as<vector<string>>();
+  auto nominalBr = parsedArgs["nominal"].as<string>();
+  auto tensorBr  = parsedArgs["tensor"].as<string>();
+
+  try {
+    auto points = parseFFPoints(parsedArgs["points"].as<string>());
+    for (const auto& tree : trees)
+      evalTree(ntpIn, ntpOut, tree, points, nominalBr, tensorBr);
+  } catch (const exception& e) {
+    cout << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,65 @@
+// Author: Yipeng Sun
+// License: BSD 2-clause
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include "utils_general.h"
+#include "utils_shard.h"
+
+using namespace std;
+
+//////////
+// Main //
+//////////
+
+int main(int argc, char** argv) {
+  cxxopts::Options argOpts("MergeRDXShards",
+                           "merge sharded ReweightRDX outputs in entry order.");
+
+  // clang-format off
+  argOpts.add_options()
+    // positional
+    ("ntpOut", "specify output ntuple.", cxxopts::value<string>())
+    ("ntpIns", "specify sharded ntuples.", cxxopts::value<vector<string>>())
+    // keyword
+    ("h,help", "print help.")
+    ("t,trees", "specify tree name.",
+     cxxopts::value<vector<string>>()
+     ->default_value("TupleBminus/DecayTree,TupleB0/DecayTree"))
+  ;
+  // setup positional argument
+  argOpts.parse_positional({"ntpOut", "ntpIns"});
+  // clang-format on
+
+  auto parsedArgs = argOpts.parse(argc, argv);
+  if (parsedArgs.count("help")) {
+    cout << argOpts.help() << endl;
+    return 0;
+  }
+  if (!parsedArgs.count("ntpIns")) {
+    cout << "ERROR: No sharded ntuples to merge." << endl;
+    cout << argOpts.help() << endl;
+    return 1;
+  }
+
+  auto ntpOut = parsedArgs["ntpOut"].as<string>();
+  auto ntpIns = parsedArgs["ntpIns"].as<vector<string>>();
+  auto trees  = parsedArgs["trees"].as<vector<string>>();
+
+  try {
+    mergeShards(ntpIns, ntpOut, trees);
+    for (const auto& tree : trees) {
+      auto [first, last] = readEntryRange(ntpOut, tree);
+      cout << "Merged " << tree << " with entries [" << first << ", " << last
+           << ")" << endl;
+    }
+  } catch (const exception& e) {
+    cout << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+}
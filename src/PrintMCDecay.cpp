@@ -22,6 +22,7 @@
 #include <cxxopts.hpp>
 
 #include "const.h"
+#include "utils_decay.h"
 #include "utils_general.h"
 
 using namespace std;
@@ -50,35 +51,10 @@ const auto DECAY_NAMES = vector<string_view>{
 };
 // clang-format on
 
-const auto BRANCH_ALIAES = vector<pair<string, string>>{
-    {"q2_true", "True_Q2"},
-    {"is_tau", "True_IsTauDecay"},
-    {"b_id", "TRUEID"},
-    {"dau0_id", "TrueHadron_D0_ID"},
-    {"dau1_id", "TrueHadron_D1_ID"},
-    {"dau2_id", "TrueHadron_D2_ID"},
-    {"dau0_gd0_id", "TrueHadron_D0_GD0_ID"},
-    {"dau0_gd1_id", "TrueHadron_D0_GD1_ID"},
-    {"dau0_gd2_id", "TrueHadron_D0_GD2_ID"},
-    {"dau1_gd0_id", "TrueHadron_D1_GD0_ID"},
-    {"dau1_gd1_id", "TrueHadron_D1_GD1_ID"},
-    {"dau1_gd2_id", "TrueHadron_D1_GD2_ID"},
-    {"dau2_gd0_id", "TrueHadron_D2_GD0_ID"},
-    {"dau2_gd1_id", "TrueHadron_D2_GD1_ID"},
-    {"dau2_gd2_id", "TrueHadron_D2_GD2_ID"},
-};
-
-const auto DECAY_SIGNATURE = vector<string>{
-    "is_tau",      "b_id",        "dau0_id",     "dau0_gd0_id", "dau0_gd1_id",
-    "dau0_gd2_id", "dau1_id",     "dau1_gd0_id", "dau1_gd1_id", "dau1_gd2_id",
-    "dau2_id",     "dau2_gd0_id", "dau2_gd1_id", "dau2_gd2_id"};
-
 /////////////
 // Helpers //
 /////////////
 
-typedef map<vector<int>, unsigned long> DecayFreq;
-
 template <typename A, typename B>
 pair<B, A> flipPair(const pair<A, B>& p) {
   return pair<B, A>(p.second, p.first);
@@ -91,39 +67,10 @@ multimap<B, A> flipMap(const map<A, B>& src) {
   return dst;
 }
 
-/////////////
-// Filters //
-/////////////
-
-bool truthMatchOk(double q2True, bool isTauDecay, int bMesonId, int dMesonId) {
-  double q2Min = 100 * 100;
-  if (isTauDecay) q2Min = 1700 * 1700;
-
-  return findIn(LEGAL_B_MESON_IDS, TMath::Abs(bMesonId)) && q2True > q2Min &&
-         isDMeson(TMath::Abs(dMesonId));  // NOTE: Taking abs is crucial!
-}
-
 //////////////
 // Printers //
 //////////////
 
-void countDecayFreq(DecayFreq& freq, unsigned long& numOfEvt,
-                    unsigned long& numOfEvtWithB, bool truthMatch,
-                    vector<int> truthSignature) {
-  numOfEvt += 1;
-
-  if (truthMatch) {
-    numOfEvtWithB += 1;
-    vector<int> key = {};
-    for (auto v : truthSignature) key.emplace_back(TMath::Abs(v));
-
-    if (freq.find(key) == freq.end())
-      freq[key] = 1l;
-    else
-      freq[key] += 1;
-  }
-}
-
 void printDecayFreq(DecayFreq freq, TDatabasePDG* db) {
   auto sorted = flipMap(freq);
   for (auto const& [val, key] : boost::adaptors::reverse(sorted)) {
@@ -174,26 +121,11 @@ int main(int argc, char** argv) {
 
   unsigned long numOfEvt      = 0;
   unsigned long numOfEvtWithB = 0;
-  auto          freq          = DecayFreq{};
   auto          db            = make_unique<TDatabasePDG>();
   auto          dfInit        = RDataFrame(tree, ntp);
 
-  // functions to be JIT'ed
-  gInterpreter->Declare(
-      "auto makeVecInt = [](auto...args) { return vector<int>{args...}; };");
-
-  auto df = defineBranch(dfInit, BRANCH_ALIAES, bMeson);
-  df      = df.Define("truthmatch", truthMatchOk,
-                 {"q2_true", "is_tau", "b_id", "dau0_id"})
-           .Define("signature",
-                   "makeVecInt(" +
-                       boost::algorithm::join(DECAY_SIGNATURE, ",") + ")");
-  df.Foreach(
-      [&](bool truthMatch, vector<int> truthSignature) {
-        countDecayFreq(freq, numOfEvt, numOfEvtWithB, truthMatch,
-                       truthSignature);
-      },
-      {"truthmatch", "signature"});
+  auto df   = defineDecaySignature(dfInit, bMeson);
+  auto freq = countDecayFreq(df, numOfEvt, numOfEvtWithB);
 
   printDecayFreq(freq, db.get());
   cout << endl;
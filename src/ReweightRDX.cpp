@@ -1,25 +1,47 @@
 // Author: Yipeng Sun, Alex Fernez
 
-// Variated parameter values generated using utils/gen_ham_params.py + 
-// gen_ham_params_no_rescale.py (the latter used for B->D(*) and the former used for
-// B->D**), with central values/errors/correlations/related parameter values set in
-// spec/rdx-run2.yml
-
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
 #include <exception>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <memory>
+#include <new>
+#include <set>
 #include <sstream>
+#include <stdexcept>
+#include <streambuf>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include <stdio.h>
-
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <TChain.h>
+#include <TDatabasePDG.h>
+#include <TDirectory.h>
+#include <TEntryList.h>
+#include <TFile.h>
+#include <TLorentzVector.h>
 #include <TMath.h>
+#include <TROOT.h>
 #include <TString.h>
+#include <TTree.h>
+#include <TTreeReader.h>
+#include <ROOT/RDF/RActionImpl.hxx>
+#include <ROOT/RDFHelpers.hxx>
 #include <ROOT/RDataFrame.hxx>
 
 #include <Hammer/Hammer.hh>
@@ -30,10 +52,25 @@
 #include <cxxopts.hpp>
 
 #include "const.h"
+#include "ff_params_default.h"
+#include "ff_params_dst10sig.h"
+#include "ff_params_dstnocorr.h"
+#include "ff_params_dstnocorr10sig.h"
+#include "ff_params_dstrun1.h"
+#include "ff_params_nominal.h"
+#include "ff_params_norescale.h"
+#include "utils_decay.h"
+#include "utils_ff_tensor.h"
 #include "utils_general.h"
 #include "utils_ham.h"
+#include "utils_ham_cache.h"
+#include "utils_parallel.h"
+#include "utils_shard.h"
+#include "utils_surrogate.h"
+#include "utils_weight_sums.h"
 
 using namespace std;
+using namespace std::chrono;
 using ROOT::RDataFrame;
 using ROOT::RDF::RNode;
 using ROOT::VecOps::RVec;
@@ -44,12 +81,18 @@ using ROOT::VecOps::RVec;
 // Configurables //
 ///////////////////
 
-//#define DEBUG_CLI
 //#define FORCE_MOMENTUM_CONSERVATION_LEPTONIC
 #define RADIATIVE_CORRECTION
 #define SOFT_PHOTON_THRESH 0.1
-
-typedef map<vector<Int_t>, unsigned long> DecayFreq;
+#define PIPELINE_QUEUE_SIZE 1024
+#define PIPELINE_WINDOW_SIZE 8192
+#define PIPELINE_CHUNK_SIZE 16
+#define PIPELINE_BATCH_SIZE 1024
+#define PIPELINE_MAX_NUM_OF_AUX_BRS 16
+#define SURROGATE_BATCH_SIZE 4096
+#define MAX_NUM_OF_PHOTONS 32
+#define HAM_LOG_SIZE 16
+#define ALLOC_WARM_UP_NUM_OF_CANDS 1000
 
 void setInputFF(Hammer::Hammer& ham, TString run) {
   if (run == "run1") {
@@ -86,533 +129,485 @@ map<string, complex<double>> specializedWC = {
     {"V_qRlL", 0}, {"T_qLlL", 0}, {"S_qLlR", 0}, {"S_qRlR", 0},
     {"V_qLlR", 0}, {"V_qRlR", 0}, {"T_qRlR", 0}};
 
-// clang-format off
-// +, -, +, -, ...
-vector<vector<string>> BtoDVars = {
-  // shifting in 1-th direction (+)...
-  {
-    "{ap: [0.012351197624241281, -0.027367962562844683, -0.07277729207579971, 0.0]}",
-    "{a0: [0.062484046787995004, -0.1572277107072667, -0.2805601501901888, 0.0]}",
-  },
-  // shifting in 1-th direction (-)...
-  {
-    "{ap: [0.01896880237575872, -0.04103203743715532, -0.10722270792420029, 0.0]}",
-    "{a0: [0.096215953212005, -0.25277228929273327, -0.1794398498098112, 0.0]}",
-  },
-  // shifting in 2-th direction (+)...
-  {
-    "{ap: [0.01591678690539162, -0.036804793342622426, -0.07049365753599796, 0.0]}",
-    "{a0: [0.08068819570228931, -0.2123544213516238, -0.23067308360617908, 0.0]}",
-  },
-  // shifting in 2-th direction (-)...
-  {
-    "{ap: [0.01540321309460838, -0.03159520665737758, -0.10950634246400204, 0.0]}",
-    "{a0: [0.0780118042977107, -0.19764557864837617, -0.22932691639382094, 0.0]}",
-  },
-  // shifting in 3-th direction (+)...
-  {
-    "{ap: [0.016629800510417916, -0.03439666118284376, -0.09000068878903926, 0.0]}",
-    "{a0: [0.08411975918337586, -0.20489880083482004, -0.2299946563017477, 0.0]}",
-  },
-  // shifting in 3-th direction (-)...
-  {
-    "{ap: [0.014690199489582086, -0.03400333881715624, -0.08999931121096073, 0.0]}",
-    "{a0: [0.07458024081662415, -0.20510119916517994, -0.23000534369825232, 0.0]}",
-  },
-  // shifting in 4-th direction (+)...
-  {
-    "{ap: [0.01587525531571869, -0.03322237162082708, -0.08993374264698996, 0.0]}",
-    "{a0: [0.08074892773777949, -0.20516187356690724, -0.23001236118642798, 0.0]}",
-  },
-  // shifting in 4-th direction (-)...
-  {
-    "{ap: [0.015444744684281312, -0.035177628379172925, -0.09006625735301003, 0.0]}",
-    "{a0: [0.07795107226222052, -0.20483812643309274, -0.22998763881357204, 0.0]}",
-  }
-};
-
-vector<vector<string>> BtoDstVars = {
-  // shifting in 1-th direction (+)...
-  {
-    "{avec: [0.001260431099035367, -0.005814457482657006, -0.024987372258585112]}",
-    "{bvec: [0.0004900145218689943, 7.466869133956658e-05, 0.0029848016188998186]}",
-    "{cvec: [2.2336792682128603e-05, 0.002339522831233444, -0.03566541618423161]}",
-    "{dvec: [0.0020844011242765284, -0.008571735209323101, 0.03473567640725931]}",
-  },
-  // shifting in 1-th direction (-)...
-  {
-    "{avec: [0.0012211197489646326, -0.005549653877342992, -0.023715962141414887]}",
-    "{bvec: [0.0004755484093310056, 8.76757566604334e-05, 0.0024266799811001817]}",
-    "{cvec: [2.5593472917871395e-05, 0.002298889968766555, -0.03700305101576838]}",
-    "{dvec: [0.0020205942037234714, -0.006966947670676899, -0.03468156159125931]}",
-  },
-  // shifting in 2-th direction (+)...
-  {
-    "{avec: [0.0015387628369786265, -0.007131957792233949, -0.035101031616549414]}",
-    "{bvec: [0.0005970822644012318, 0.00010237454067166451, 0.0034572861427716907]}",
-    "{cvec: [2.780849764268198e-05, 0.0021380081108407323, -0.02835811244570046]}",
-    "{dvec: [0.002539299800309922, -0.009928456447903296, -0.0003855357904247226]}",
-  },
-  // shifting in 2-th direction (-)...
-  {
-    "{avec: [0.000942788011021373, -0.004232153567766049, -0.01360230278345059]}",
-    "{bvec: [0.0003684806667987682, 5.9969907328335465e-05, 0.0019541954572283096]}",
-    "{cvec: [2.0121767957318017e-05, 0.002500404689159267, -0.04431035475429953]}",
-    "{dvec: [0.0015656955276900776, -0.005610226432096703, 0.00043965060642472254]}",
-  },
-  // shifting in 3-th direction (+)...
-  {
-    "{avec: [0.0011944443127184525, -0.005038648081395574, -0.024998540920203566]}",
-    "{bvec: [0.0004678529136803674, 0.00017872786959570949, -0.0015031853253623566]}",
-    "{cvec: [3.315476147439584e-05, 0.002133188698409768, -0.03648934835435856]}",
-    "{dvec: [0.001983601899842271, -0.007033613662738017, 7.172198921323677e-05]}",
-  },
-  // shifting in 3-th direction (-)...
-  {
-    "{avec: [0.001287106535281547, -0.006325463278604424, -0.023704793479796434]}",
-    "{bvec: [0.0004977100175196325, -1.638342159570951e-05, 0.006914666925362357]}",
-    "{cvec: [1.477550412560416e-05, 0.0025052241015902314, -0.03617911884564143]}",
-    "{dvec: [0.0021213934281577285, -0.008505069217261983, -1.7607173213236773e-05]}",
-  },
-  // shifting in 4-th direction (+)...
-  {
-    "{avec: [0.0010525834985406642, -0.005539398065100158, -0.024839002422353804]}",
-    "{bvec: [0.00040007024225617046, 0.00010215297346911433, 0.00316670932085098]}",
-    "{cvec: [2.9873722179234278e-05, 0.002089597326599368, -0.036454496301279]}",
-    "{dvec: [0.001695750537909285, -0.0058208626148416615, 6.292224991778452e-05]}",
-  },
-  // shifting in 4-th direction (-)...
-  {
-    "{avec: [0.0014289673494593353, -0.00582471329489984, -0.023864331977646196]}",
-    "{bvec: [0.0005654926889438294, 6.019147453088565e-05, 0.0022447722791490202]}",
-    "{cvec: [1.805654342076572e-05, 0.002548815473400631, -0.03621397089872099]}",
-    "{dvec: [0.0024092447900907147, -0.009717820265158338, -8.807433917784529e-06]}",
-  },
-  // shifting in 5-th direction (+)...
-  {
-    "{avec: [0.0012075850974850877, -0.005408495873000874, -0.024379032588291473]}",
-    "{bvec: [0.0004702385858323742, 0.00011930190186244815, 0.0027596695898884447]}",
-    "{cvec: [4.9439312756620866e-05, 0.001729530841348389, -0.03636946480320376]}",
-    "{dvec: [0.0020141697196403383, -0.007891848135727951, 2.5423063900131175e-05]}",
-  },
-  // shifting in 5-th direction (-)...
-  {
-    "{avec: [0.0012739657505149119, -0.005955615486999124, -0.024324301811708526]}",
-    "{bvec: [0.0004953243453676257, 4.3042546137551814e-05, 0.0026518120101115556]}",
-    "{cvec: [-1.5090471566208716e-06, 0.0029088819586516102, -0.03629900239679623]}",
-    "{dvec: [0.0020908256083596614, -0.007646834744272048, 2.869175209986882e-05]}",
-  },
-  // shifting in 6-th direction (+)...
-  {
-    "{avec: [0.0013941961600586292, -0.005752250078470359, -0.024335912951066713]}",
-    "{bvec: [0.0005505690398239217, 0.0001129750440107342, 0.0027021039962866504]}",
-    "{cvec: [3.481670698011398e-05, 0.00224601582532898, -0.036331843535330095]}",
-    "{dvec: [0.002323926197539937, -0.0077008863683725864, 2.834272417602903e-05]}",
-  },
-  // shifting in 6-th direction (-)...
-  {
-    "{avec: [0.0010873546879413703, -0.005611861281529639, -0.024367421448933287]}",
-    "{bvec: [0.0004149938913760782, 4.936940398926576e-05, 0.00270937760371335]}",
-    "{cvec: [1.3113558619886017e-05, 0.002392396974671019, -0.036336623664669894]}",
-    "{dvec: [0.0017810691304600624, -0.007837796511627413, 2.5772091823970966e-05]}",
-  },
-  // shifting in 7-th direction (+)...
-  {
-    "{avec: [0.0012454313752453725, -0.005613848189523626, -0.024359267901695007]}",
-    "{bvec: [0.00048589371414307, 0.0001990769235573227, 0.002717452094888066]}",
-    "{cvec: [3.1204932268956716e-05, 0.0023597717881083022, -0.03633446023379283]}",
-    "{dvec: [0.0020649995839086663, -0.0077726602657066145, 2.6995779467860616e-05]}",
-  },
-  // shifting in 7-th direction (-)...
-  {
-    "{avec: [0.001236119472754627, -0.005750263170476372, -0.024344066498304992]}",
-    "{bvec: [0.00047966921705692994, -3.673247555732273e-05, 0.002694029505111934]}",
-    "{cvec: [1.672533333104328e-05, 0.002278641011891697, -0.03633400696620716]}",
-    "{dvec: [0.0020399957440913334, -0.007766022614293385, 2.711903653213938e-05]}",
-  },
-  // shifting in 8-th direction (+)...
-  {
-    "{avec: [0.0012490993646979737, -0.005653192783471472, -0.024355228700926254]}",
-    "{bvec: [0.00048165109815985875, 5.796526338073458e-05, 0.002709457132419868]}",
-    "{cvec: [3.397776021702497e-05, 0.0023310263169516133, -0.036334623627886614]}",
-    "{dvec: [0.0020612874833442064, -0.00776927100384874, 2.7058188885903403e-05]}",
-  },
-  // shifting in 8-th direction (-)...
-  {
-    "{avec: [0.0012324514833020259, -0.005710918576528526, -0.024348105699073745]}",
-    "{bvec: [0.00048391183304014116, 0.00010437918461926539, 0.0027020244675801325]}",
-    "{cvec: [1.3952505382975026e-05, 0.002307386483048386, -0.036333843572113375]}",
-    "{dvec: [0.0020437078446557933, -0.0077694118761512596, 2.7056627114096593e-05]}",
-  },
-  // shifting in 9-th direction (+)...
-  {
-    "{avec: [0.0012246529983434185, -0.005681364543193438, -0.024351814454451295]}",
-    "{bvec: [0.00048047004114849676, 8.023782795287083e-05, 0.002705870051600037]}",
-    "{cvec: [2.3352662048822048e-05, 0.002319727168433616, -0.03633424482385493]}",
-    "{dvec: [0.0020626132108799377, -0.007769190131293707, 2.705982770755252e-05]}",
-  },
-  // shifting in 9-th direction (-)...
-  {
-    "{avec: [0.001256897849656581, -0.0056827468168065606, -0.024351519945548704]}",
-    "{bvec: [0.00048509289005150316, 8.210662004712915e-05, 0.002705611548399963]}",
-    "{cvec: [2.457760355117795e-05, 0.002318685631566383, -0.03633422237614506]}",
-    "{dvec: [0.002042382117120062, -0.0077694927487062925, 2.7054988292447474e-05]}",
-  },
-  // shifting in 10-th direction (+)...
-  {
-    "{avec: [0.0012396272967539704, -0.0056823690258229675, -0.024351632250586955]}",
-    "{bvec: [0.0004871191595490027, 8.117865822067813e-05, 0.0027056998296810207]}",
-    "{cvec: [2.6922346617834093e-05, 0.002319199324290693, -0.03633422467676812]}",
-    "{dvec: [0.0020518615497555942, -0.007769352606630588, 2.705722714449867e-05]}",
-  },
-  // shifting in 10-th direction (-)...
-  {
-    "{avec: [0.001241923551246029, -0.005681742334177031, -0.024351702149413044]}",
-    "{bvec: [0.0004784437716509972, 8.116578977932184e-05, 0.0027057817703189796]}",
-    "{cvec: [2.1007918982165905e-05, 0.0023192134757093062, -0.03633424252323187]}",
-    "{dvec: [0.0020531337782444055, -0.007769330273369412, 2.7057588855501326e-05]}",
-  },
-  // shifting in 11-th direction (+)...
-  {
-    "{avec: [0.0012407115735699984, -0.0056816925430860435, -0.02435171285388519]}",
-    "{bvec: [0.00048376543120609697, 8.099043285636128e-05, 0.0027057898823278845]}",
-    "{cvec: [2.2535039512706306e-05, 0.0023192918178923396, -0.03633424172055911]}",
-    "{dvec: [0.0020524868475665435, -0.007769341577600906, 2.7057405639191926e-05]}",
-  },
-  // shifting in 11-th direction (-)...
-  {
-    "{avec: [0.0012408392744300012, -0.005682418816913955, -0.02435162154611481]}",
-    "{bvec: [0.00048179749999390295, 8.13540151436387e-05, 0.002705691717672116]}",
-    "{cvec: [2.5395226087293692e-05, 0.0023191209821076596, -0.03633422547944088]}",
-    "{dvec: [0.0020525084804334562, -0.0077693413023990935, 2.705741036080807e-05]}",
-  }
-};
-
-vector<vector<string>> BtoD0starVars = {
-  // shifting in 1-th direction (+)...
-  {
-    "{ztp: 3.0}",
-    "{zeta1: 0.6}",
-  },
-  // shifting in 1-th direction (-)...
-  {
-    "{ztp: -2.5999999999999996}",
-    "{zeta1: 0.6}",
-  },
-  // shifting in 2-th direction (+)...
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 1.2}",
-  },
-  // shifting in 2-th direction (-)...
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 0.0}",
-  }
-};
+string decayDescr(const string decay) {
+  // the pattern seems to be you just need to insert the word "to"
+  // I'm going to assume the fact (that should be fine for our analysis) that the
+  // decay string only contains 'D' once (where the name of the daughter begins)
+  auto daughterPos = decay.find("D");
+  auto bMeson = decay.substr(0,daughterPos);
+  auto daughter = decay.substr(daughterPos);
+  return bMeson + "to" + daughter;
+}
 
-vector<vector<string>> BtoD1Vars = {
-  /// shifting in 1-th direction (+)...
-  {
-    "{tp: -1.2000000000000002}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 1-th direction (-)...
-  {
-    "{tp: -2.0}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 2-th direction (+)...
-  {
-    "{tp: -1.6}",
-    "{tau1: 0.09999999999999998}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 2-th direction (-)...
-  {
-    "{tp: -1.6}",
-    "{tau1: -1.1}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 3-th direction (+)...
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 5.699999999999999}",
-  },
-  // shifting in 3-th direction (-)...
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 0.10000000000000009}",
-  }
+//////////////
+// Variants //
+//////////////
+
+// The variants differ only in their output FF parameters, so all of them can be
+// registered in the same HAMMER instance and share a single 'processEvent'.
+// Each variant gets its own FF scheme names and FF labels (offset by
+// 'labelOffset'); the nominal variant keeps the original ones.
+// Decays in 'ffEigenVarSpecs' can be varied w/ eigenvector variations of a
+// single '*Var' FF instead of a separately configured FF per variation.
+struct FFVariant {
+  string                                                      name;
+  string                                                      brPrefix;
+  int                                                         labelOffset;
+  map<string, vector<vector<string>>>                         ffVarSpecs;
+  map<string, string>                                         ffSchemeByDecay;
+  map<string, function<void(Hammer::Hammer&, const string)>> ffSchemeDefaults;
+  int                                                         numOfFFVar;
+  map<string, vector<map<string, double>>>                    ffEigenVarSpecs{};
+  map<string, string>                                         ffEigenSchemeByDecay{};
+  bool                                                        ffTensor = false;
 };
 
-vector<vector<string>> BtoD1starVars = {
-  // shifting in 1-th direction (+)...
-  {
-    "{ztp: 3.0}",
-    "{zeta1: 0.6}",
-  },
-  // shifting in 1-th direction (-)...
-  {
-    "{ztp: -2.5999999999999996}",
-    "{zeta1: 0.6}",
-  },
-  // shifting in 2-th direction (+)...
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 1.2}",
-  },
-  // shifting in 2-th direction (-)...
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 0.0}",
-  }
+// clang-format off
+const vector<FFVariant> FF_VARIANTS = {
+  {"nominal", "wff", 0,
+   ffNominal::ffVarSpecs, ffNominal::ffSchemeByDecay,
+   ffNominal::ffSchemeDefaultsByDecay, ffNominal::numOfFFVar,
+   ffNominal::ffEigenVarSpecs, ffNominal::ffEigenSchemeByDecay},
+  {"default", "wff_orig", 100,
+   ffDefault::ffVarSpecs, ffDefault::ffSchemeByDecay,
+   ffDefault::ffSchemeDefaultsByDecay, ffDefault::numOfFFVar},
+  {"dst10sig", "wff_dst10sig", 200,
+   ffDst10Sig::ffVarSpecs, ffDst10Sig::ffSchemeByDecay,
+   ffDst10Sig::ffSchemeDefaultsByDecay, ffDst10Sig::numOfFFVar},
+  {"dstnocorr", "wff_dstnocorr", 300,
+   ffDstNoCorr::ffVarSpecs, ffDstNoCorr::ffSchemeByDecay,
+   ffDstNoCorr::ffSchemeDefaultsByDecay, ffDstNoCorr::numOfFFVar},
+  {"dstnocorr10sig", "wff_dstnocorr10sig", 400,
+   ffDstNoCorr10Sig::ffVarSpecs, ffDstNoCorr10Sig::ffSchemeByDecay,
+   ffDstNoCorr10Sig::ffSchemeDefaultsByDecay, ffDstNoCorr10Sig::numOfFFVar},
+  {"dstrun1", "wff_dstrun1", 500,
+   ffDstRun1::ffVarSpecs, ffDstRun1::ffSchemeByDecay,
+   ffDstRun1::ffSchemeDefaultsByDecay, ffDstRun1::numOfFFVar},
+  {"norescale", "wff_norescale", 600,
+   ffRemoveRescale::ffVarSpecs, ffRemoveRescale::ffSchemeByDecay,
+   ffRemoveRescale::ffSchemeDefaultsByDecay, ffRemoveRescale::numOfFFVar}
 };
+// clang-format on
 
-vector<vector<string>> BtoD2starVars = {
-  // shifting in 1-th direction (+)...
-  {
-    "{tp: -1.2000000000000002}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 1-th direction (-)...
-  {
-    "{tp: -2.0}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 2-th direction (+)...
-  {
-    "{tp: -1.6}",
-    "{tau1: 0.09999999999999998}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 2-th direction (-)...
-  {
-    "{tp: -1.6}",
-    "{tau1: -1.1}",
-    "{tau2: 2.9}",
-  },
-  // shifting in 3-th direction (+)...
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 5.699999999999999}",
-  },
-  // shifting in 3-th direction (-)...
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 0.10000000000000009}",
+// 'all' selects every variant
+vector<FFVariant> selectVariants(const vector<string>& names) {
+  if (names.size() == 1 && names[0] == "all") return FF_VARIANTS;
+
+  auto result = vector<FFVariant>{};
+  for (const auto& name : names) {
+    auto variant = find_if(FF_VARIANTS.begin(), FF_VARIANTS.end(),
+                           [&](const FFVariant& v) { return v.name == name; });
+    if (variant == FF_VARIANTS.end())
+      throw invalid_argument("Unknown FF variant: " + name);
+    result.emplace_back(*variant);
   }
-};
-
-// Various FF config
-map<string, vector<vector<string>>> ffVarSpecs = {
-  {"BD", BtoDVars},
-  {"BD*", BtoDstVars},
-  {"BD**0*", BtoD0starVars},
-  {"BD**1", BtoD1Vars},
-  {"BD**1*", BtoD1starVars},
-  {"BD**2*", BtoD2starVars},
-  {"BsDs**1", BtoD1Vars},
-  {"BsDs**2*", BtoD2starVars}
-};
-
-map<string, string> ffSchemeByDecay = {
-  {"BD", "BGL"},
-  {"BD*", "BGL"},
-  {"BD**0*", "BLR"},
-  {"BD**1", "BLR"},
-  {"BD**1*", "BLR"},
-  {"BD**2*", "BLR"},
-  {"BsDs**1", "BLR"},
-  {"BsDs**2*", "BLR"}
-};
-
-void setBtoDBGLDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {ChiT: 0.0005131}");
-  ham.setOptions(scheme + ": {ChiL: 0.006332}");
-  ham.setOptions(scheme + ": {BcStatesp: [6.329, 6.92, 7.02]}");
-  ham.setOptions(scheme + ": {BcStates0: [6.716, 7.121]}");
-  ham.setOptions(scheme + ": {ap: [0.01566, -0.0342, -0.09, 0.0]}");
-  ham.setOptions(scheme + ": {a0: [0.07935, -0.205, -0.23, 0.0]}");
-}
-
-void setBtoDstarBGLDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {Vcb: 0.0384}");
-  ham.setOptions(scheme + ": {Chim: 0.0003894}");
-  ham.setOptions(scheme + ": {Chip: 0.0005131}");
-  ham.setOptions(scheme + ": {ChimL: 0.019421}");
-  ham.setOptions(scheme + ": {BcStatesf: [6.739, 6.75, 7.145, 7.15]}");
-  ham.setOptions(scheme + ": {BcStatesg: [6.329, 6.92, 7.02]}");
-  ham.setOptions(scheme + ": {BcStatesP1: [6.275, 6.842, 7.25]}");
-  ham.setOptions(scheme + ": {avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}");
-  ham.setOptions(scheme + ": {bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}");
-  ham.setOptions(scheme + ": {cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}");
-  ham.setOptions(scheme + ": {dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}");
-}
-
-void setBtoD0starBLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {zt1: 0.7}");
-  ham.setOptions(scheme + ": {ztp: 0.2}");
-  ham.setOptions(scheme + ": {zeta1: 0.6}");
-  ham.setOptions(scheme + ": {chi1: 0.0}");
-  ham.setOptions(scheme + ": {chi2: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laS: 0.76}");
-};
-
-void setBtoD1BLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {t1: 0.7}");
-  ham.setOptions(scheme + ": {tp: -1.6}");
-  ham.setOptions(scheme + ": {tau1: -0.5}");
-  ham.setOptions(scheme + ": {tau2: 2.9}");
-  ham.setOptions(scheme + ": {eta1: 0.0}");
-  ham.setOptions(scheme + ": {eta2: 0.0}");
-  ham.setOptions(scheme + ": {eta3: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laP: 0.8}");
-};
-
-void setBtoD1starBLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {zt1: 0.7}");
-  ham.setOptions(scheme + ": {ztp: 0.2}");
-  ham.setOptions(scheme + ": {zeta1: 0.6}");
-  ham.setOptions(scheme + ": {chi1: 0.0}");
-  ham.setOptions(scheme + ": {chi2: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laS: 0.76}");
-};
+  return result;
+}
 
-void setBtoD2starBLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {t1: 0.7}");
-  ham.setOptions(scheme + ": {tp: -1.6}");
-  ham.setOptions(scheme + ": {tau1: -0.5}");
-  ham.setOptions(scheme + ": {tau2: 2.9}");
-  ham.setOptions(scheme + ": {eta1: 0.0}");
-  ham.setOptions(scheme + ": {eta2: 0.0}");
-  ham.setOptions(scheme + ": {eta3: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laP: 0.8}");
-};
+// varIdx = 0 is the nominal scheme, varIdx = i the i-th variation
+string ffLabel(const FFVariant& variant, int varIdx) {
+  auto label = variant.labelOffset + varIdx;
+  if (label == 0) return "";
+  return "_" + to_string(label);
+}
 
-map<string, function<void(Hammer::Hammer&, const string)>>
-ffSchemeDefaultsByDecay = {
-  {"BD", setBtoDBGLDefault},
-  {"BD*", setBtoDstarBGLDefault},
-  {"BD**0*", setBtoD0starBLRDefault},
-  {"BD**1", setBtoD1BLRDefault},
-  {"BD**1*", setBtoD1starBLRDefault},
-  {"BD**2*", setBtoD2starBLRDefault},
-  {"BsDs**1", setBtoD1BLRDefault},
-  {"BsDs**2*", setBtoD2starBLRDefault}
-};
-// clang-format on
+// The '*Var' FF of a decay w/ eigenvector variations, shared by the nominal
+// scheme and all variation schemes of the variant
+string eigenFF(const FFVariant& variant, const string& decay) {
+  return variant.ffEigenSchemeByDecay.at(decay) + ffLabel(variant, 0);
+}
 
-const int numOfFFVar = 22;
+string outputScheme(const FFVariant& variant, int varIdx) {
+  auto scheme =
+      varIdx ? "OutputFFVar" + to_string(varIdx) : string("OutputFF");
+  if (variant.labelOffset) scheme += "_" + variant.name;
+  return scheme;
+}
 
-string decayDescr(const string decay) {
-  // the pattern seems to be you just need to insert the word "to"
-  // I'm going to assume the fact (that should be fine for our analysis) that the
-  // decay string only contains 'D' once (where the name of the daughter begins)
-  auto daughterPos = decay.find("D");
-  auto bMeson = decay.substr(0,daughterPos);
-  auto daughter = decay.substr(daughterPos);
-  return bMeson + "to" + daughter;
+// For each variant, the nominal weight followed by its variations
+size_t numOfWeights(const vector<FFVariant>& variants) {
+  size_t result = 0;
+  for (const auto& variant : variants) result += 1 + variant.numOfFFVar;
+  return result;
 }
 
-vector<string> setOutputFF(Hammer::Hammer& ham) {
-  vector<string> hamFFSchemes{"OutputFF"};
+void setOutputFF(Hammer::Hammer& ham, const FFVariant& variant) {
+  map<string, string> nominalSchemes{};
+  for (auto const& [decay, ffName] : variant.ffSchemeByDecay)
+    nominalSchemes[decay] = variant.ffEigenVarSpecs.count(decay)
+                                ? eigenFF(variant, decay)
+                                : ffName + ffLabel(variant, 0);
+  ham.addFFScheme(outputScheme(variant, 0), nominalSchemes);
 
-  ham.addFFScheme("OutputFF", ffSchemeByDecay);
   // Set defaults
-  for (auto [decay, ffName] : ffSchemeByDecay) {
+  for (auto const& [decay, ffName] : nominalSchemes) {
     auto fullDescr = decayDescr(decay) + ffName;
     cout << "Decay: " << decay << "; default FF: " << fullDescr << endl;
-    ffSchemeDefaultsByDecay[decay](ham, fullDescr);
+    variant.ffSchemeDefaults.at(decay)(ham, fullDescr);
   }
 
   // Set variations
-  for (int i = 1; i <= numOfFFVar; i++) {
-    cout << "Configuring FF scheme: OutputFFVar" + to_string(i) << endl;
+  for (int i = 1; i <= variant.numOfFFVar; i++) {
+    cout << "Configuring FF scheme: " << outputScheme(variant, i) << endl;
     map<string, string> schemes{};
-    for (auto const& [decay, vars] : ffVarSpecs) {
+    for (auto const& [decay, vars] : variant.ffVarSpecs) {
+      // the eigenvectors of the nominal FF are set per candidate instead
+      if (variant.ffEigenVarSpecs.count(decay)) {
+        if (i <= variant.ffEigenVarSpecs.at(decay).size()) {
+          schemes[decay] = nominalSchemes[decay];
+          cout << "  Eigenvector variation for decay: " << decay
+               << "; with FF: " << decayDescr(decay) + schemes[decay] << endl;
+        }
+        continue;
+      }
+
       if (i <= vars.size()) {
         // Need to reweight the decay in this HAMMER scheme
-        auto ffName    = ffSchemeByDecay[decay] + "_" + to_string(i);
-        auto descr     = decayDescr(decay);
+        auto ffName = variant.ffSchemeByDecay.at(decay) + ffLabel(variant, i);
+        auto descr  = decayDescr(decay);
         schemes[decay] = ffName;
         // Configure the FF scheme defaults for this decay
         cout << "  Variation for decay: " << decay
              << "; with FF: " << descr + ffName << endl;
-        ffSchemeDefaultsByDecay[decay](ham, descr + ffName);
+        variant.ffSchemeDefaults.at(decay)(ham, descr + ffName);
         for (auto const& shift : vars[i - 1])
           ham.setOptions(descr + ffName + ": " +
                          shift);  // configure FF variations
       }
     }
-    ham.addFFScheme("OutputFFVar" + to_string(i), schemes);
+    ham.addFFScheme(outputScheme(variant, i), schemes);
   }
+}
+
+// clang-format off
+const auto HAM_DECAYS = vector<string>{
+  "BDTauNu", "BDMuNu",
+  "BD*TauNu", "BD*MuNu",
+  "BD**0*TauNu", "BD**1TauNu", "BD**1*TauNu", "BD**2*TauNu",
+  "BD**0*MuNu", "BD**1MuNu", "BD**1*MuNu", "BD**2*MuNu",
+  "BsDs**1MuNu", "BsDs**2*MuNu"
+};
+// clang-format on
+
+void setDecays(Hammer::Hammer& ham, const vector<string>& decays) {
+  for (const auto& decay : decays) ham.includeDecay(decay);
+}
+
+// Returns the configuration hash, and the path of the rate cache of this
+// configuration, if enabled
+pair<string, string> initHammer(Hammer::Hammer& ham, const string run,
+                                const vector<FFVariant>& variants,
+                                const vector<string>&    decays = HAM_DECAYS,
+                                const string rateCacheDir       = "") {
+  setDecays(ham, decays);
+  setInputFF(ham, run);
+  for (const auto& variant : variants) setOutputFF(ham, variant);
+
+  ham.setUnits("MeV");
+  ham.setOptions("ProcessCalc: {CheckForNaNs: true}");
+
+  auto configHash = hamConfigHash(ham);
+  auto cachePath  = string{};
+  if (rateCacheDir != "") cachePath = rateCachePath(configHash, rateCacheDir);
+
+  auto startInit = high_resolution_clock::now();
+  ham.initRun();
+  if (cachePath != "" && loadRateCache(ham, cachePath))
+    cout << "Restored HAMMER rates from " << cachePath << endl;
+  auto stopInit = high_resolution_clock::now();
+  cout << "HAMMER initRun took "
+       << duration_cast<milliseconds>(stopInit - startInit).count() << " ms"
+       << endl;
+
+  // only use SM Wilson coefficients
+  ham.specializeWCInWeights("BtoCTauNu", specializedWC);
+  ham.specializeWCInWeights("BtoCMuNu", specializedWC);
+
+  return {configHash, cachePath};
+}
+
+////////////
+// Census //
+////////////
+
+// A prepass over the truth IDs finds the decays actually present in the input
+// ntuples, so that HAMMER is configured only for those
+
+// clang-format off
+const auto HAM_D_MESONS = map<int, string>{
+  {411, "D"}, {421, "D"},
+  {413, "D*"}, {423, "D*"},
+  {10411, "D**0*"}, {10421, "D**0*"},
+  {10413, "D**1"}, {10423, "D**1"},
+  {20413, "D**1*"}, {20423, "D**1*"},
+  {415, "D**2*"}, {425, "D**2*"},
+  {10433, "Ds**1"},
+  {435, "Ds**2*"}
+};
+// clang-format on
+
+// The FF-level decay (e.g. 'BD*') of a truth-matched decay signature, or "" if
+// not known to HAMMER
+string hamFFDecay(int bId, int dId) {
+  auto bMeson = TMath::Abs(bId) == 531 ? string("Bs") : string("B");
+  auto dMeson = HAM_D_MESONS.find(TMath::Abs(dId));
+  if (dMeson == HAM_D_MESONS.end()) return "";
+  return bMeson + dMeson->second;
+}
+
+string hamFFDecay(const vector<int>& signature) {
+  return hamFFDecay(signature[1], signature[2]);
+}
+
+string hamDecay(int bId, int dId, bool isTau) {
+  auto ffDecay = hamFFDecay(bId, dId);
+  if (ffDecay == "") return "";
+  return ffDecay + (isTau ? "TauNu" : "MuNu");
+}
+
+string hamDecay(const vector<int>& signature) {
+  return hamDecay(signature[1], signature[2], signature[0]);
+}
+
+// The variations of an FF-level decay, w/ their output schemes resolved once.
+// Like in 'setOutputFF', variation i of a variant only covers the decays w/ at
+// least i variations; the weights of the others stay at 1.0.
+struct DecayVar {
+  size_t              wtIdx;
+  string              scheme;
+  string              eigenFF{};   // only for eigenvector variations
+  map<string, double> eigenVar{};  // ditto
+};
+
+struct DecayVars {
+  string           decay;
+  string           process;
+  vector<DecayVar> vars{};
+  vector<string>   eigenFFs{};  // to be reset after the variations
+};
+
+typedef pair<bool, int> FFDecayKey;  // (is B_s, abs. ID of the D meson)
 
-  return hamFFSchemes;
+FFDecayKey ffDecayKey(int bId, int dId) {
+  return {TMath::Abs(bId) == 531, TMath::Abs(dId)};
 }
 
-void setDecays(Hammer::Hammer& ham) {
-  ham.includeDecay("BDTauNu");
-  ham.includeDecay("BDMuNu");
+map<FFDecayKey, DecayVars> buildDecayVars(const vector<FFVariant>& variants) {
+  auto result = map<FFDecayKey, DecayVars>{};
+  for (const auto& [dId, dMeson] : HAM_D_MESONS) {
+    for (auto bId : {511, 531}) {
+      auto  decay = hamFFDecay(bId, dId);
+      auto& entry = result[ffDecayKey(bId, dId)];
+      entry       = DecayVars{decay, decayDescr(decay)};
+
+      size_t offset = 0;
+      for (const auto& variant : variants) {
+        auto vars      = variant.ffVarSpecs.find(decay);
+        auto eigenVars = variant.ffEigenVarSpecs.find(decay);
+        bool hasVars   = vars != variant.ffVarSpecs.end();
+        bool hasEigen  = eigenVars != variant.ffEigenVarSpecs.end();
+
+        for (int i = 1; hasVars && i <= variant.numOfFFVar; i++) {
+          if (hasEigen && i <= static_cast<int>(eigenVars->second.size()))
+            entry.vars.emplace_back(DecayVar{offset + i,
+                                             outputScheme(variant, i),
+                                             eigenFF(variant, decay),
+                                             eigenVars->second[i - 1]});
+          else if (!hasEigen && i <= static_cast<int>(vars->second.size()))
+            entry.vars.emplace_back(
+                DecayVar{offset + i, outputScheme(variant, i)});
+        }
+        if (hasVars && hasEigen)
+          entry.eigenFFs.emplace_back(eigenFF(variant, decay));
+
+        offset += 1 + variant.numOfFFVar;
+      }
+    }
+  }
+  return result;
+}
+
+// The decays in 'HAM_DECAYS' present in any of the input trees
+vector<string> censusDecays(const vector<pair<string, string>>& ntpPairs,
+                            const vector<string>&               trees,
+                            const vector<string>&               bMesons) {
+  auto present = set<string>{};
+  for (const auto& [ntpIn, ntpOut] : ntpPairs) {
+    for (int idx = 0; idx != trees.size(); idx++) {
+      unsigned long numOfEvt      = 0;
+      unsigned long numOfEvtWithB = 0;
+
+      auto dfInit = RDataFrame(trees[idx], ntpIn);
+      auto df     = defineDecaySignature(dfInit, bMesons[idx]);
+      auto freq   = countDecayFreq(df, numOfEvt, numOfEvtWithB);
+      for (const auto& [signature, num] : freq) {
+        auto decay = hamDecay(signature);
+        if (decay == "") continue;
+        present.insert(decay);
+      }
+    }
+  }
+
+  auto result = vector<string>{};
+  for (const auto& decay : HAM_DECAYS)
+    if (present.count(decay)) result.emplace_back(decay);
+  return result;
+}
 
-  ham.includeDecay("BD*TauNu");
-  ham.includeDecay("BD*MuNu");
+// e.g. 'BD*MuNu' -> 'BD*'
+string ffDecayOf(const string& decay) {
+  auto pos = decay.rfind("TauNu");
+  if (pos == string::npos) pos = decay.rfind("MuNu");
+  return decay.substr(0, pos);
+}
 
-  ham.includeDecay("BD**0*TauNu");
-  ham.includeDecay("BD**1TauNu");
-  ham.includeDecay("BD**1*TauNu");
-  ham.includeDecay("BD**2*TauNu");
+// Drop the FFs of decays not present. The number of variations is unchanged,
+// so the output branches stay the same.
+FFVariant restrictVariant(FFVariant variant, const vector<string>& decays) {
+  auto ffDecays = set<string>{};
+  for (const auto& decay : decays) ffDecays.insert(ffDecayOf(decay));
 
-  ham.includeDecay("BD**0*MuNu");
-  ham.includeDecay("BD**1MuNu");
-  ham.includeDecay("BD**1*MuNu");
-  ham.includeDecay("BD**2*MuNu");
+  auto restrict = [&](auto& ffMap) {
+    for (auto it = ffMap.begin(); it != ffMap.end();)
+      it = ffDecays.count(it->first) ? next(it) : ffMap.erase(it);
+  };
 
-  ham.includeDecay("BsDs**1MuNu");
-  ham.includeDecay("BsDs**2*MuNu");
+  restrict(variant.ffVarSpecs);
+  restrict(variant.ffSchemeByDecay);
+  restrict(variant.ffEigenVarSpecs);
+  restrict(variant.ffEigenSchemeByDecay);
+  return variant;
 }
 
 /////////////
 // Helpers //
 /////////////
 
-// For muting hammer logging
-// NOTE: Hammer always uses 'stdout' for logging
-int muteStdout() {
-  fflush(stdout);
-  int  fd      = dup(STDOUT_FILENO);
-  auto devNull = freopen("/dev/null", "w", stdout);
-  return fd;
+// HAMMER logs to 'cout'. Instead of muting 'stdout' around HAMMER calls,
+// 'cout' is routed once through 'HamLogBuf': while a thread captures, its
+// output goes to a per-thread ring buffer of the last HAM_LOG_SIZE lines, which
+// can still be printed for failed candidates.
+struct HamLog {
+  bool                        capturing = false;
+  array<string, HAM_LOG_SIZE> lines{};
+  size_t                      numOfLines = 0;  // incl. overwritten ones
+  string                      pending{};       // current, unfinished line
+
+  void append(const char* data, streamsize size) {
+    for (streamsize idx = 0; idx != size; idx++) {
+      if (data[idx] != '\n') {
+        pending += data[idx];
+        continue;
+      }
+      lines[numOfLines++ % HAM_LOG_SIZE].swap(pending);
+      pending.clear();
+    }
+  }
+};
+
+thread_local HamLog hamLog{};
+
+class HamLogBuf : public streambuf {
+ public:
+  explicit HamLogBuf(streambuf* out) : out(out) {}
+
+ protected:
+  int_type overflow(int_type chr) override {
+    if (traits_type::eq_int_type(chr, traits_type::eof()))
+      return traits_type::not_eof(chr);
+    auto data = traits_type::to_char_type(chr);
+    if (!hamLog.capturing) return out->sputc(data);
+    hamLog.append(&data, 1);
+    return chr;
+  }
+
+  streamsize xsputn(const char* data, streamsize size) override {
+    if (!hamLog.capturing) return out->sputn(data, size);
+    hamLog.append(data, size);
+    return size;
+  }
+
+  int sync() override { return hamLog.capturing ? 0 : out->pubsync(); }
+
+ private:
+  streambuf* out;
+};
+
+// NOTE: Call once, before any HAMMER is created.
+//       'cout' outlives all static objects, so the buffer is never freed.
+//       At exit, 'cout' is restored to its original buffer, as the per-thread
+//       logs are destroyed before 'cout' is flushed for the last time.
+streambuf* coutBuf   = nullptr;
+HamLogBuf* hamLogBuf = nullptr;
+
+void routeHamLog() {
+  coutBuf   = cout.rdbuf();
+  hamLogBuf = new HamLogBuf(coutBuf);
+  cout.rdbuf(hamLogBuf);
+  atexit([] { cout.rdbuf(coutBuf); });
+}
+
+void captureHamLog() {
+  hamLog.numOfLines = 0;
+  hamLog.pending.clear();
+  hamLog.capturing = true;
 }
 
-void restoreStdout(int fd) {
-  fflush(stdout);
-  dup2(fd, fileno(stdout));
-  close(fd);
+void releaseHamLog() { hamLog.capturing = false; }
+
+void printHamLog() {
+  auto   first = hamLog.numOfLines > HAM_LOG_SIZE
+                     ? hamLog.numOfLines - HAM_LOG_SIZE
+                     : 0;
+  string msg{};
+  if (first > 0)
+    msg += "  HAMMER: (" + to_string(first) + " earlier lines dropped)\n";
+  for (auto idx = first; idx != hamLog.numOfLines; idx++)
+    msg += "  HAMMER: " + hamLog.lines[idx % HAM_LOG_SIZE] + '\n';
+  if (!hamLog.pending.empty()) msg += "  HAMMER: " + hamLog.pending + '\n';
+  cout << msg;
+}
+
+// Heap allocations of the current thread, to check that the per-candidate path
+// outside of HAMMER doesn't allocate once the per-slot buffers are warmed up.
+// This replaces the global operator new, so it's only built into the
+// ReweightRDXAllocCount diagnostic binary (w/ -DCOUNT_HEAP_ALLOCS).
+#ifdef COUNT_HEAP_ALLOCS
+thread_local unsigned long numOfHeapAllocs = 0;
+
+void* operator new(size_t size) {
+  numOfHeapAllocs += 1;
+  if (auto ptr = malloc(size ? size : 1)) return ptr;
+  throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+
+unsigned long heapAllocs() { return numOfHeapAllocs; }
+#else
+unsigned long heapAllocs() { return 0; }
+#endif
+
+// Per-candidate tracing, configured once from the CLI before any event loop:
+//   1: the FF weight of each candidate
+//   2: also the particles added to HAMMER
+// Messages are only formatted for traced candidates.
+enum TraceLevel { TRACE_OFF = 0, TRACE_WEIGHTS = 1, TRACE_PARTS = 2 };
+
+// Candidates are selected by their entry in the input tree (INPUT_ENTRY_BR),
+// which is the same w/ any number of threads, shard or partial range. The
+// events at the nodes of a surrogate grid are traced by their node index.
+struct TraceConfig {
+  unsigned int   level = TRACE_OFF;
+  set<ULong64_t> entries{};  // all candidates if empty
+};
+
+TraceConfig traceCfg{};
+
+bool traced(unsigned int level, ULong64_t entry) {
+  return traceCfg.level >= level &&
+         (traceCfg.entries.empty() || traceCfg.entries.count(entry));
 }
 
 /////////////
@@ -655,20 +650,78 @@ bool isSoftPhoton(Hammer::Particle part) {
   return false;
 }
 
-bool isSoftPhoton(HamPartCtn part) {
-  auto pe = get<0>(part);
+bool isSoftPhoton(float pe) {
   if (pe < SOFT_PHOTON_THRESH) return true;
   return false;
 }
 
-vector<HamPartCtn> buildPhotonVec(RVec<float>& arrPe, RVec<float>& arrPx,
-                                  RVec<float>& arrPy, RVec<float>& arrPz,
-                                  RVec<float>& arrId, int size) {
-  vector<HamPartCtn> result{};
+// The radiative photons of a candidate w/ the B, the D or the primary lepton
+// as mother, bucketed in that order; photons of other mothers are never added
+// to HAMMER. Up to MAX_NUM_OF_PHOTONS photons are stored inline, so that they
+// are never heap-allocated; candidates w/ more photons have all of them in
+// 'overflow' instead.
+struct PhotonArr {
+  array<HamPartCtn, MAX_NUM_OF_PHOTONS> parts{};
+  size_t                                size = 0;
+  vector<HamPartCtn>                    overflow{};
+
+  const HamPartCtn* begin() const {
+    return overflow.empty() ? parts.data() : overflow.data();
+  }
+  const HamPartCtn* end() const {
+    return overflow.empty() ? parts.data() + size
+                            : overflow.data() + overflow.size();
+  }
+};
+
+// A single pass over the photons applies the soft photon cut and finds the
+// bucket of each; tuples are only built for the kept photons
+PhotonArr buildPhotonVec(RVec<float>& arrPe, RVec<float>& arrPx,
+                         RVec<float>& arrPy, RVec<float>& arrPz,
+                         RVec<float>& arrMomId, int size, HamPartCtn& pB,
+                         HamPartCtn& pD, HamPartCtn& pL) {
+  auto momIds = array<int, 3>{TMath::Abs(get<4>(pB)), TMath::Abs(get<4>(pD)),
+                              TMath::Abs(get<4>(pL))};
+  // the bucket of a photon, or 'momIds.size()' if it's not kept
+  auto bucketOf = [&](int idx) {
+    if (isSoftPhoton(arrPe[idx])) return momIds.size();
+    auto   momId = TMath::Abs(static_cast<int>(arrMomId[idx]));
+    size_t mom   = 0;
+    while (mom != momIds.size() && momIds[mom] != momId) mom++;
+    return mom;
+  };
+  auto buildPhoton = [&](int idx) {
+    return buildPartVec(arrPe[idx], arrPx[idx], arrPy[idx], arrPz[idx],
+                        static_cast<int>(arrMomId[idx]));
+  };
+
+  // indices of the kept photons, by mother
+  auto buckets    = array<array<int, MAX_NUM_OF_PHOTONS>, 3>{};
+  auto bucketSize = array<size_t, 3>{};
+
+  size_t numOfKept = 0;
   for (auto idx = 0; idx != size; idx++) {
-    auto part = buildPartVec(arrPe[idx], arrPx[idx], arrPy[idx], arrPz[idx],
-                             static_cast<int>(arrId[idx]));
-    if (!isSoftPhoton(part)) result.emplace_back(part);
+    auto mom = bucketOf(idx);
+    if (mom == momIds.size()) continue;
+    if (numOfKept++ < MAX_NUM_OF_PHOTONS)
+      buckets[mom][bucketSize[mom]++] = idx;
+  }
+
+  auto result = PhotonArr{};
+  // rare, so the photons are simply scanned again for each bucket
+  if (numOfKept > MAX_NUM_OF_PHOTONS) {
+    result.overflow.reserve(numOfKept);
+    for (size_t mom = 0; mom != momIds.size(); mom++)
+      for (auto idx = 0; idx != size; idx++)
+        if (bucketOf(idx) == mom)
+          result.overflow.emplace_back(buildPhoton(idx));
+    return result;
+  }
+
+  for (size_t mom = 0; mom != buckets.size(); mom++) {
+    for (size_t pos = 0; pos != bucketSize[mom]; pos++) {
+      result.parts[result.size++] = buildPhoton(buckets[mom][pos]);
+    }
   }
   return result;
 }
@@ -686,21 +739,108 @@ string printP(Hammer::Particle part) {
   return buffer.str();
 }
 
-string addRadiativePhotons(Hammer::Process& proc, Hammer::ParticleIndices& idx,
-                           int refMomId, vector<HamPartCtn>& photons) {
-  stringstream buffer;
+//////////////////////
+// Process template //
+//////////////////////
+
+// Positions in the particle list of a candidate; radiative photons come last,
+// w/ the ID of their mother in place of their own
+enum CandPart {
+  PART_B,
+  PART_D,
+  PART_L,
+  PART_NUL,
+  PART_D_DAU0,
+  PART_D_DAU1,
+  PART_D_DAU2,
+  PART_MU,
+  PART_NUMU,
+  PART_NUTAU,
+  PART_PHOTONS
+};
+
+const auto CAND_PART_NAMES = vector<string>{"B meson",
+                                            "D meson",
+                                            "primary charged lepton",
+                                            "primary neutrino",
+                                            "D daughter",
+                                            "D daughter",
+                                            "D daughter",
+                                            "secondary lepton",
+                                            "secondary lepton",
+                                            "secondary lepton"};
+
+// The tau flag, followed by the IDs of all particles of a candidate
+typedef vector<int> ProcTopology;
+
+void procTopology(ProcTopology& key, bool isTau,
+                  const vector<HamPartCtn>& parts) {
+  key.clear();
+  key.emplace_back(isTau);
+  for (const auto& p : parts) key.emplace_back(get<4>(p));
+}
+
+// The structure of the HAMMER process of a topology: the particles in the
+// order they are added, and the vertices in terms of their indices.
+// NOTE: A 'Hammer::Process' can't update the momenta of its particles, and
+//       HAMMER takes a new process for each event, so only the structure is
+//       reused. Indices are assigned in the order particles are added.
+struct ProcTemplate {
+  vector<size_t>                                               parts;
+  vector<pair<Hammer::ParticleIndex, Hammer::ParticleIndices>> vertices;
+};
+
+ProcTemplate buildProcTemplate(bool isTau, const vector<HamPartCtn>& parts) {
+  auto tmpl = ProcTemplate{};
+  auto add  = [&](size_t pos) -> Hammer::ParticleIndex {
+    tmpl.parts.emplace_back(pos);
+    return tmpl.parts.size() - 1;
+  };
 
-  for (const auto& p : photons) {
-    auto [pe, px, py, pz, photonMomId] = p;
-    if (photonMomId == refMomId || photonMomId == -refMomId) {
-      auto partPhoton = buildHamPart(pe, px, py, pz, 22);
-      idx.emplace_back(proc.addParticle(partPhoton));
-      buffer << "  Adding photon: " << printP(pe, px, py, pz) << " to "
-             << refMomId << endl;
+  // photons are bucketed by mother (see 'buildPhotonVec'), and the mothers
+  // are visited in the same order, so each photon is only looked at once
+  size_t photon     = PART_PHOTONS;
+  auto   addPhotons = [&](Hammer::ParticleIndices& idx, size_t refMom) {
+#ifdef RADIATIVE_CORRECTION
+    auto refMomId = TMath::Abs(get<4>(parts[refMom]));
+    for (; photon != parts.size() &&
+           TMath::Abs(get<4>(parts[photon])) == refMomId;
+         photon++)
+      idx.emplace_back(add(photon));
+#endif
+  };
+
+  // B meson and its direct daughters
+  auto partBIdx    = add(PART_B);
+  auto partDIdx    = add(PART_D);
+  auto partLIdx    = add(PART_L);
+  auto partBDauIdx = Hammer::ParticleIndices{partDIdx, partLIdx, add(PART_NUL)};
+  addPhotons(partBDauIdx, PART_B);
+  tmpl.vertices.emplace_back(partBIdx, partBDauIdx);
+
+  // in case of a D*, add its daughters as well
+  auto partDDauIdx = Hammer::ParticleIndices{};
+  addPhotons(partDDauIdx, PART_D);
+  if (isDstMeson(get<4>(parts[PART_D]))) {
+    for (auto pos : {PART_D_DAU0, PART_D_DAU1, PART_D_DAU2}) {
+      // don't add placeholder particle
+      // don't add photons as it will be a duplicate
+      auto id = get<4>(parts[pos]);
+      if (id == 0 || id == 22) continue;
+      partDDauIdx.emplace_back(add(pos));
     }
   }
+  if (partDDauIdx.size()) tmpl.vertices.emplace_back(partDIdx, partDDauIdx);
 
-  return buffer.str();
+  // in case of a Tau, add its daughters
+  auto partLDauIdx = Hammer::ParticleIndices{};
+  addPhotons(partLDauIdx, PART_L);
+  if (isTau)
+    for (auto pos : {PART_MU, PART_NUMU, PART_NUTAU})
+      partLDauIdx.emplace_back(add(pos));
+  if (partLDauIdx.size()) tmpl.vertices.emplace_back(partLIdx, partLDauIdx);
+
+  return tmpl;
 }
 
 /////////////////
@@ -768,13 +908,6 @@ pair<RNode, vector<string>> prepHamInput(RNode df, string bMesonName) {
       df.Define("part_D_dau2", buildPartVec, getDauTrueP(bMesonName, "D0_GD2"));
 
 #ifdef RADIATIVE_CORRECTION
-  // the radiative photons container
-  df = df.Define("part_photon_arr", buildPhotonVec,
-                 setBrPrefix(bMesonName, {"MCTrue_gamma_E", "MCTrue_gamma_PX",
-                                          "MCTrue_gamma_PY", "MCTrue_gamma_PZ",
-                                          "MCTrue_gamma_mother_ID",
-                                          "MCTrue_gamma_ArrayLength"}));
-
   // Tau/Mu, Nu_Tau/Nu_Mu associated w/ B -> D decay
   df = df.Define("part_Tau_id", tauIdFix, {"mu_TRUEID"});
   df = df.Define(
@@ -818,121 +951,327 @@ pair<RNode, vector<string>> prepHamInput(RNode df, string bMesonName) {
                              {"TrueTauNuMu_PE", "TrueTauNuMu_PX",
                               "TrueTauNuMu_PY", "TrueTauNuMu_PZ"},
                              {"part_NuMu_id"}));
+
+  // the radiative photons container
+  df = df.Define(
+      "part_photon_arr", buildPhotonVec,
+      setBrPrefix(bMesonName,
+                  {"MCTrue_gamma_E", "MCTrue_gamma_PX", "MCTrue_gamma_PY",
+                   "MCTrue_gamma_PZ", "MCTrue_gamma_mother_ID",
+                   "MCTrue_gamma_ArrayLength"},
+                  {"part_B", "part_D", "part_L"}));
 #else
   // this is just a place holder in case we don't add radiative photons back!
-  df = df.Define("part_photon_arr", []() { return vector<HamPartCtn>{}; }, {});
+  df = df.Define("part_photon_arr", []() { return PhotonArr{}; }, {});
 #endif
 
   return {df, outputBrs};
 }
 
-auto reweightWrapper(Hammer::Hammer& ham, unsigned long& numOfEvt,
-                     unsigned long& numOfEvtOk, vector<string>& schemes) {
-  return [&](bool truthMatchOk, bool isTau, HamPartCtn pB, HamPartCtn pD,
-             HamPartCtn pDDau0, HamPartCtn pDDau1, HamPartCtn pDDau2,
-             HamPartCtn pL, HamPartCtn pNuL, HamPartCtn pMu, HamPartCtn pNuMu,
-             HamPartCtn pNuTau, vector<HamPartCtn> pPhotons) {
-    bool                      hamOk = true;
-    double                    wtFF  = 1.0;
-    array<double, numOfFFVar> wtFFVars;
-    fill_n(wtFFVars.begin(), numOfFFVar, 1.0);  // all default to 1.0
+// HAMMER weights of all variants, laid out as in 'numOfWeights'. The event loop
+// gets 'ff_result' as a pointer to a result owned by the slot (or by the
+// previous output), so that it's never copied.
+struct FFResult {
+  bool           hamOk;
+  vector<double> weights;
+  vector<double> ffTensor{};
+  string         ffTensorDecay{};
+};
 
-    string debugMsg = "====\n";
-    numOfEvt += 1;
-    if (!truthMatchOk)
-      // FIXME: it's ugly! but not sure RDataFrame frame can deduce type if we
-      // use anything fancy.
-      return tuple<bool, double, double, double, double, double, double, double,
-                   double, double, double, double, double, double, double,
-                   double, double, double, double, double, double, double,
-                   double, double>{
-          false,        wtFF,         wtFFVars[0],  wtFFVars[1],  wtFFVars[2],
-          wtFFVars[3],  wtFFVars[4],  wtFFVars[5],  wtFFVars[6],  wtFFVars[7],
-          wtFFVars[8],  wtFFVars[9],  wtFFVars[10], wtFFVars[11], wtFFVars[12],
-          wtFFVars[13], wtFFVars[14], wtFFVars[15], wtFFVars[16], wtFFVars[17],
-          wtFFVars[18], wtFFVars[19], wtFFVars[20], wtFFVars[21]};
+// Results of a previous output for the entries of a topped-up input
+struct PrevResults {
+  vector<Long64_t> prevEntries;  // by input entry, -1 for new candidates
+  vector<FFResult> results;      // by previous output entry
+};
 
-    Hammer::Process proc;
-    auto            partB   = buildHamPart(pB);
-    auto            partD   = buildHamPart(pD);
-    auto            partL   = buildHamPart(pL);
-    auto            partNuL = buildHamPart(pNuL);
-    auto particles = vector<Hammer::Particle>{partB, partD, partL, partNuL};
-
-    // add B meson
-    auto partBIdx = proc.addParticle(partB);
-
-    debugMsg += "  B meson 4-mom: " + printP(partB) + '\n';
-    debugMsg += "  D meson 4-mom: " + printP(partD) + '\n';
-    debugMsg += "  primary charged lepton 4-mom: " + printP(partL) + '\n';
-    debugMsg += "  primary neutrino 4-mom: " + printP(partNuL) + '\n';
-
-    // add direct B daughters
-    auto                    partDIdx   = proc.addParticle(partD);
-    auto                    partLIdx   = proc.addParticle(partL);
-    auto                    partNuLIdx = proc.addParticle(partNuL);
-    Hammer::ParticleIndices partBDauIdx{partDIdx, partLIdx, partNuLIdx};
-#ifdef RADIATIVE_CORRECTION
-    debugMsg += addRadiativePhotons(proc, partBDauIdx, partB.pdgId(), pPhotons);
-#endif
-    proc.addVertex(partBIdx, partBDauIdx);
+// Everything needed to probe the FF tensor of a decay w/ eigenvector variations
+struct FFTensorSpec {
+  string         process;
+  string         ffName;
+  string         scheme;
+  vector<string> params;
+  vector<double> steps;
+};
 
-    // in case of a D*, add its daughters as well
-    Hammer::ParticleIndices partDDauIdx{};
-#ifdef RADIATIVE_CORRECTION
-    debugMsg += addRadiativePhotons(proc, partDDauIdx, partD.pdgId(), pPhotons);
-#endif
+// By FF-level decay, e.g. 'BD*'
+map<string, FFTensorSpec> buildTensorSpecs(const vector<FFVariant>& variants) {
+  auto result = map<string, FFTensorSpec>{};
+  for (const auto& variant : variants) {
+    if (!variant.ffTensor) continue;
+    for (const auto& [decay, eigenVars] : variant.ffEigenVarSpecs)
+      result[decay] = FFTensorSpec{decayDescr(decay), eigenFF(variant, decay),
+                                   outputScheme(variant, 0),
+                                   tensorParams(eigenVars),
+                                   tensorSteps(eigenVars)};
+  }
+  return result;
+}
 
-    bool isDst = isDstMeson(get<4>(pD));
-    if (isDst) {
-      auto partDDaus = {buildHamPart(pDDau0), buildHamPart(pDDau1),
-                        buildHamPart(pDDau2)};
-      for (const auto& p : partDDaus) {
-        // don't add placeholder particle
-        // don't add photons as it will be a duplicate
-        if (p.pdgId() == 0 || p.pdgId() == 22) continue;
-        partDDauIdx.emplace_back(proc.addParticle(p));
-        particles.emplace_back(p);
-        debugMsg += "  D daughters: " + printP(p) + "\n";
+// Resets the eigenvectors of 'numOfFFs' FFs when going out of scope, so that a
+// failed probe or variation doesn't leave them shifted for the following
+// candidates. A failed reset is logged, and doesn't skip the other FFs.
+struct FFEigenvectorsGuard {
+  Hammer::Hammer& ham;
+  const string&   process;
+  const string*   ffNames;
+  size_t          numOfFFs = 1;
+
+  ~FFEigenvectorsGuard() {
+    for (size_t idx = 0; idx != numOfFFs; idx++) {
+      try {
+        ham.resetFFEigenvectors(process, ffNames[idx]);
+      } catch (const exception& e) {
+        cout << "ERROR: Can't reset eigenvectors of " << ffNames[idx] << ": "
+             << e.what() << endl;
       }
     }
-    if (partDDauIdx.size()) proc.addVertex(partDIdx, partDDauIdx);
+  }
+};
 
-    // in case of a Tau, add its daughters
-    Hammer::ParticleIndices partLDauIdx{};
-#ifdef RADIATIVE_CORRECTION
-    debugMsg += addRadiativePhotons(proc, partLDauIdx, partL.pdgId(), pPhotons);
-#endif
+// The weight is exactly quadratic in the shifts, so 1 + 2n + n(n - 1)/2
+// weights w/ shifted eigenvectors determine all coefficients
+vector<double> probeFFTensor(Hammer::Hammer& ham, const FFTensorSpec& spec) {
+  auto guard       = FFEigenvectorsGuard{ham, spec.process, &spec.ffName};
+  auto numOfParams = spec.params.size();
+  auto shifts      = map<string, double>{};
+  for (const auto& param : spec.params) shifts[param] = 0.0;
+
+  auto weightAt = [&](vector<pair<size_t, double>> deltas) {
+    auto point = shifts;
+    for (const auto& [idx, delta] : deltas) point[spec.params[idx]] = delta;
+    ham.setFFEigenvectors(spec.process, spec.ffName, point);
+    return ham.getWeight(spec.scheme);
+  };
 
-    if (isTau) {
-      auto partLDaus = {buildHamPart(pMu), buildHamPart(pNuMu),
-                        buildHamPart(pNuTau)};
-      for (const auto& p : partLDaus) {
-        partLDauIdx.emplace_back(proc.addParticle(p));
-        particles.emplace_back(p);
-        debugMsg += "  secondary leptons: " + printP(p) + "\n";
-      }
+  auto result = vector<double>(tensorSize(numOfParams), 0.0);
+  auto coeff  = [&](size_t i, size_t j) -> double& {
+    return result[tensorIdx(i, j, numOfParams)];
+  };
+  auto& steps = spec.steps;
+
+  coeff(0, 0) = weightAt({});
+  for (size_t i = 0; i != numOfParams; i++) {
+    auto wtUp   = weightAt({{i, steps[i]}});
+    auto wtDown = weightAt({{i, -steps[i]}});
+
+    coeff(0, i + 1) = (wtUp - wtDown) / (2 * steps[i]);
+    coeff(i + 1, i + 1) =
+        ((wtUp + wtDown) / 2 - coeff(0, 0)) / (steps[i] * steps[i]);
+  }
+  for (size_t i = 0; i != numOfParams; i++) {
+    for (size_t j = i + 1; j != numOfParams; j++) {
+      auto wt = weightAt({{i, steps[i]}, {j, steps[j]}});
+      wt -= coeff(0, 0) + coeff(0, i + 1) * steps[i] +
+            coeff(0, j + 1) * steps[j] +
+            coeff(i + 1, i + 1) * steps[i] * steps[i] +
+            coeff(j + 1, j + 1) * steps[j] * steps[j];
+      coeff(i + 1, j + 1) = wt / (steps[i] * steps[j]);
+    }
+  }
+
+  return result;
+}
+
+// Reco candidates of the same MC event often share identical truth, hence
+// identical weights. Such candidates are adjacent in the ntuples, so each slot
+// only keeps the results of its current event, keyed by the full truth content.
+// An event has only a few candidates, so the entries are searched linearly, and
+// the entries of previous events are overwritten in place to reuse their
+// buffers. The results are computed directly into the entries, which never
+// move, so that the event loop can be handed pointers to them.
+struct TruthCache {
+  UInt_t                        runNumber   = 0;
+  ULong64_t                     eventNumber = 0;
+  deque<pair<string, FFResult>> results{};
+  size_t                        numOfResults = 0;  // of the current event
+  unsigned long                 numOfLookups = 0;
+  unsigned long                 numOfHits    = 0;
+
+  void            clear() { numOfResults = 0; }
+  const FFResult* find(const string& key) const;
+  FFResult&       insert(const string& key);
+};
+
+const FFResult* TruthCache::find(const string& key) const {
+  for (size_t idx = 0; idx != numOfResults; idx++)
+    if (results[idx].first == key) return &results[idx].second;
+  return nullptr;
+}
+
+// The entry keeps the buffers of a previous event, to be overwritten
+FFResult& TruthCache::insert(const string& key) {
+  if (numOfResults == results.size())
+    results.emplace_back(key, FFResult{false, {}});
+  else
+    results[numOfResults].first.assign(key);
+  return results[numOfResults++].second;
+}
+
+// Appended field by field, as tuples may have padding
+void appendTruth(string& key, const HamPartCtn& part) {
+  auto [pe, px, py, pz, id] = part;
+  for (auto val : {pe, px, py, pz})
+    key.append(reinterpret_cast<const char*>(&val), sizeof(val));
+  key.append(reinterpret_cast<const char*>(&id), sizeof(id));
+}
+
+void truthFingerprint(string& key, bool isTau,
+                      const vector<HamPartCtn>& parts) {
+  key.assign(1, isTau);
+  for (const auto& part : parts) appendTruth(key, part);
+}
+
+// Per-slot buffers for assembling an event, w/ enough capacity that they never
+// grow, unless a candidate has more than MAX_NUM_OF_PHOTONS photons. The
+// results live in the truth cache.
+struct EventScratch {
+  map<ProcTopology, ProcTemplate> templates{};
+  vector<HamPartCtn>              parts{};
+  ProcTopology                    topology{};
+  string                          truthKey{};
+  FFResult                        failed{false, {}};  // not truth-matched
+
+  EventScratch() {
+    auto numOfParts = PART_PHOTONS + MAX_NUM_OF_PHOTONS;
+    parts.reserve(numOfParts);
+    topology.reserve(numOfParts + 1);
+    truthKey.reserve(numOfParts * (4 * sizeof(double) + sizeof(int)) + 1);
+  }
+};
+
+// Each RDataFrame slot gets its own Hammer instance and counters, so slots
+// never share mutable state
+auto reweightWrapper(vector<unique_ptr<Hammer::Hammer>>& hams,
+                     vector<unsigned long>&              numOfEvtBySlot,
+                     vector<unsigned long>&              numOfEvtOkBySlot,
+                     vector<microseconds>&               timeBySlot,
+                     vector<TruthCache>&                 cacheBySlot,
+                     vector<unsigned long>&              numOfEvtReusedBySlot,
+                     vector<unsigned long>&              numOfEvtAllocBySlot,
+                     vector<unsigned long>&              numOfSteadyAllocBySlot,
+                     vector<unsigned long>&              numOfVarFailBySlot,
+                     const PrevResults*                  prev,
+                     const vector<FFVariant>&            variants) {
+  auto numOfWts       = numOfWeights(variants);
+  auto tensorSpecs    = buildTensorSpecs(variants);
+  auto decayVars      = buildDecayVars(variants);
+  auto scratchBySlot  = make_shared<vector<EventScratch>>(hams.size());
+  auto nominalSchemes = vector<string>{};
+  for (const auto& variant : variants)
+    nominalSchemes.emplace_back(outputScheme(variant, 0));
+
+  return [&, numOfWts, tensorSpecs, decayVars, scratchBySlot, nominalSchemes,
+          prev](
+             unsigned int slot, ULong64_t entry, UInt_t runNumber,
+             ULong64_t eventNumber, bool truthMatchOk, bool isTau,
+             const HamPartCtn& pB, const HamPartCtn& pD,
+             const HamPartCtn& pDDau0, const HamPartCtn& pDDau1,
+             const HamPartCtn& pDDau2, const HamPartCtn& pL,
+             const HamPartCtn& pNuL, const HamPartCtn& pMu,
+             const HamPartCtn& pNuMu, const HamPartCtn& pNuTau,
+             const PhotonArr& pPhotons) {
+    auto& ham        = *hams[slot];
+    auto& numOfEvt   = numOfEvtBySlot[slot];
+    auto& numOfEvtOk = numOfEvtOkBySlot[slot];
+    auto& cache      = cacheBySlot[slot];
+
+    // the whole path but HAMMER itself, up to the result handed to the event
+    // loop, which points into per-slot storage valid until the next candidate
+    // of the slot. Allocations after the warm-up of the slot are counted
+    // separately.
+    auto  allocs      = heapAllocs();
+    auto& scratch     = (*scratchBySlot)[slot];
+    auto  countAllocs = [&] {
+      if (heapAllocs() == allocs) return;
+      numOfEvtAllocBySlot[slot] += 1;
+      if (numOfEvt > ALLOC_WARM_UP_NUM_OF_CANDS)
+        numOfSteadyAllocBySlot[slot] += 1;
+    };
+
+    bool   traceParts = traced(TRACE_PARTS, entry);
+    string traceMsg{};
+    numOfEvt += 1;
+
+    // candidates already in the previous output are not reweighted again.
+    // NOTE: 'entry' must be the entry of the input tree, not 'rdfentry_'
+    if (prev != nullptr && prev->prevEntries[entry] >= 0) {
+      numOfEvtReusedBySlot[slot] += 1;
+      const auto& prevResult = prev->results[prev->prevEntries[entry]];
+      if (prevResult.hamOk) numOfEvtOk += 1;
+      return &prevResult;
     }
-    if (partLDauIdx.size()) proc.addVertex(partLIdx, partLDauIdx);
-
-    // make sure invariant mass is not negative
-    auto partInvMOk = vector<bool>{};
-    for (const auto& p : particles) {
-      if (p.p().mass() >= 0)
-        partInvMOk.emplace_back(true);
-      else
-        partInvMOk.emplace_back(false);
+
+    if (!truthMatchOk) {
+      scratch.failed.weights.assign(numOfWts, 1.0);
+      countAllocs();
+      return static_cast<const FFResult*>(&scratch.failed);
     }
-    bool allPartsOk =
-        find(partInvMOk.begin(), partInvMOk.end(), false) == partInvMOk.end();
-    if (!allPartsOk) {
-      cout << "  WARN: Bad kinematics for candidate: " << numOfEvt << endl;
-      hamOk = false;
+
+    if (cache.runNumber != runNumber || cache.eventNumber != eventNumber) {
+      cache.clear();
+      cache.runNumber   = runNumber;
+      cache.eventNumber = eventNumber;
     }
 
-#ifdef DEBUG_CLI
-    cout << debugMsg;
-#endif
+    // event assembly, up to the HAMMER process
+    auto& parts = scratch.parts;
+    parts.assign(
+        {pB, pD, pL, pNuL, pDDau0, pDDau1, pDDau2, pMu, pNuMu, pNuTau});
+    parts.insert(parts.end(), pPhotons.begin(), pPhotons.end());
+
+    truthFingerprint(scratch.truthKey, isTau, parts);
+    cache.numOfLookups += 1;
+    auto cached = cache.find(scratch.truthKey);
+    if (cached != nullptr) {
+      cache.numOfHits += 1;
+      if (cached->hamOk) numOfEvtOk += 1;
+      countAllocs();
+      return cached;
+    }
+
+    auto& result = cache.insert(scratch.truthKey);
+    auto& wtFFs  = result.weights;
+    bool  hamOk  = true;
+    result.hamOk = false;
+    wtFFs.assign(numOfWts, 1.0);  // all default to 1.0
+    result.ffTensor.clear();
+    result.ffTensorDecay.clear();
+
+    auto start = high_resolution_clock::now();
+
+    procTopology(scratch.topology, isTau, parts);
+    auto tmpl = scratch.templates.find(scratch.topology);
+    if (tmpl == scratch.templates.end())
+      tmpl = scratch.templates
+                 .emplace(scratch.topology, buildProcTemplate(isTau, parts))
+                 .first;
+
+    // allocations by HAMMER are not counted
+    auto hamAllocs = heapAllocs();
+    Hammer::Process proc;
+    for (auto pos : tmpl->second.parts) {
+      auto [pe, px, py, pz, id] = parts[pos];
+      auto part = buildHamPart(pe, px, py, pz, pos >= PART_PHOTONS ? 22 : id);
+      if (traceParts)
+        traceMsg += "  " +
+                    (pos >= PART_PHOTONS ? "photon" : CAND_PART_NAMES[pos]) +
+                    ": " + printP(part) + '\n';
+      // make sure invariant mass is not negative
+      if (pos < PART_PHOTONS && part.p().mass() < 0) hamOk = false;
+      proc.addParticle(part);
+    }
+    for (const auto& [parentIdx, dauIdx] : tmpl->second.vertices)
+      proc.addVertex(parentIdx, dauIdx);
+
+    if (!hamOk)
+      cout << "  WARN: Bad kinematics for candidate: " << entry << endl;
+
+    if (traceParts) cout << "==== " + to_string(entry) + '\n' + traceMsg;
+
+    // HAMMER's own messages are only printed when it fails on the candidate
+    bool   captured = hamOk;
+    string hamErr{};
+    if (captured) captureHamLog();
 
     // add the whole decay chain to hammer and see if it likes it
     if (hamOk) {
@@ -941,83 +1280,1672 @@ auto reweightWrapper(Hammer::Hammer& ham, unsigned long& numOfEvt,
       try {
         procId = ham.addProcess(proc);
       } catch (const exception& e) {
-        cout << "  WARN: HAMMER doesn't add process properly: " << numOfEvt
-             << endl;
-        cout << e.what() << endl;
-        hamOk = false;
+        hamErr = "  WARN: HAMMER doesn't add process properly: " +
+                 to_string(entry) + '\n' + e.what() + '\n';
       }
       if (procId == 0) hamOk = false;
     }
 
-    // compute FF weight
-    auto nominalFFScheme = schemes[0];
+    // compute FF weights, all variants share the same processed event
     if (hamOk) {
       try {
         ham.processEvent();
-        wtFF = ham.getWeight(nominalFFScheme);
+        size_t offset = 0;
+        for (size_t idx = 0; idx != variants.size(); idx++) {
+          wtFFs[offset] = ham.getWeight(nominalSchemes[idx]);
+          if (isnan(wtFFs[offset]) || isinf(wtFFs[offset])) hamOk = false;
+          offset += 1 + variants[idx].numOfFFVar;
+        }
       } catch (const exception& e) {
-        cout << "  WARN: HAMMER doesn't like candidate for reweighting: "
-             << numOfEvt << endl;
-        cout << e.what() << endl;
+        hamErr = "  WARN: HAMMER doesn't like candidate for reweighting: " +
+                 to_string(entry) + '\n' + e.what() + '\n';
         hamOk = false;
       }
 
-      if (isnan(wtFF) || isinf(wtFF)) hamOk = false;
-
       if (hamOk) {
-        numOfEvtOk += 1;
-        // compute various FF variation weights here
-        // failure's allowed because not all FF schemes require 20 variations!
-        auto fd = muteStdout();
-        try {
-          for (int i = 0; i < numOfFFVar; i++) {
-            auto ffName = "OutputFFVar" + to_string(i + 1);
-            wtFFVars[i] = ham.getWeight(ffName);
+        // only the variations covering the decay of the candidate. 'hamOk'
+        // only depends on the nominal weights: on a failure, the failed and
+        // remaining variations get a NaN weight, and are counted.
+        auto decayVar = decayVars.find(ffDecayKey(get<4>(pB), get<4>(pD)));
+        if (decayVar != decayVars.end()) {
+          const auto& [decay, process, vars, eigenFFs] = decayVar->second;
+          size_t numOfVarsOk = 0;
+          {
+            // the nominal weight of the next candidate needs the nominal FF
+            auto guard = FFEigenvectorsGuard{ham, process, eigenFFs.data(),
+                                             eigenFFs.size()};
+            try {
+              for (const auto& var : vars) {
+                if (!var.eigenFF.empty())
+                  ham.setFFEigenvectors(process, var.eigenFF, var.eigenVar);
+                wtFFs[var.wtIdx] = ham.getWeight(var.scheme);
+                numOfVarsOk += 1;
+              }
+            } catch (const exception& e) {
+              hamErr += "  WARN: HAMMER fails on FF variation " +
+                        vars[numOfVarsOk].scheme + " of candidate: " +
+                        to_string(entry) + '\n' + e.what() + '\n';
+              for (auto idx = numOfVarsOk; idx != vars.size(); idx++)
+                wtFFs[vars[idx].wtIdx] = numeric_limits<double>::quiet_NaN();
+              numOfVarFailBySlot[slot] += 1;
+            }
+          }
+
+          auto tensorSpec = tensorSpecs.find(decay);
+          if (hamOk && tensorSpec != tensorSpecs.end()) {
+            try {
+              result.ffTensor      = probeFFTensor(ham, tensorSpec->second);
+              result.ffTensorDecay = decay;
+            } catch (const exception& e) {
+              result.ffTensor.clear();
+            }
           }
-        } catch (const exception& e) {
         }
-        restoreStdout(fd);
+        if (hamOk) numOfEvtOk += 1;
       }
     }
 
-#ifdef DEBUG_CLI
-    if (hamOk) cout << "  FF weight: " << wtFF << endl;
-#endif
+    allocs += heapAllocs() - hamAllocs;
+
+    if (captured) {
+      releaseHamLog();
+      if (!hamOk || !hamErr.empty()) {
+        cout << hamErr;
+        printHamLog();
+      }
+    }
 
-    // FIXME: it's ugly! but not sure RDataFrame frame can deduce type if we
-    // use anything fancy.
-    return tuple<bool, double, double, double, double, double, double, double,
-                 double, double, double, double, double, double, double, double,
-                 double, double, double, double, double, double, double, double>{
-        hamOk,        wtFF,         wtFFVars[0],  wtFFVars[1],  wtFFVars[2],
-        wtFFVars[3],  wtFFVars[4],  wtFFVars[5],  wtFFVars[6],  wtFFVars[7],
-        wtFFVars[8],  wtFFVars[9],  wtFFVars[10], wtFFVars[11], wtFFVars[12],
-        wtFFVars[13], wtFFVars[14], wtFFVars[15], wtFFVars[16], wtFFVars[17],
-        wtFFVars[18], wtFFVars[19], wtFFVars[20], wtFFVars[21]};
+    if (hamOk && traced(TRACE_WEIGHTS, entry))
+      cout << "  FF weight of " + to_string(entry) + ": " +
+                  to_string(wtFFs[0]) + '\n';
+
+    timeBySlot[slot] +=
+        duration_cast<microseconds>(high_resolution_clock::now() - start);
+
+    result.hamOk = hamOk;
+    countAllocs();
+    return static_cast<const FFResult*>(&result);
   };
 }
 
-//////////
-// Main //
-//////////
+///////////////////
+// Event loop/IO //
+///////////////////
 
-int main(int argc, char** argv) {
-  cxxopts::Options argOpts("ReweightRDX", "Reweight RDX FF w/ HAMMER.");
+typedef vector<unique_ptr<Hammer::Hammer>> HamPool;
+
+// Everything needed to reweight a single tree. The event loop references the
+// counters, so a job must outlive its event loop.
+struct TreeJob {
+  string                tree;
+  string                bMeson;
+  EntryRange            range;
+  bool                  partialRange = false;  // filter the input to 'range'
+  vector<unsigned long> numOfEvtBySlot{};
+  vector<unsigned long> numOfEvtOkBySlot{};
+  vector<microseconds>  timeBySlot{};
+  vector<TruthCache>    cacheBySlot{};
+  vector<unsigned long> numOfEvtReusedBySlot{};
+  vector<unsigned long> numOfEvtAllocBySlot{};
+  vector<unsigned long> numOfSteadyAllocBySlot{};  // after the warm-up
+  vector<unsigned long> numOfVarFailBySlot{};
+
+  shared_ptr<const PrevResults> prev{};  // only in incremental mode
+
+  ROOT::RDF::RResultPtr<WeightSumsByMode> weightSums{};
+};
 
-  // clang-format off
-  argOpts.add_options()
-    // positional
-    ("ntpIn", "specify input ntuple.", cxxopts::value<string>())
-    ("ntpOut", "specify output ntuple.", cxxopts::value<string>())
-    ("extra", "unused.", cxxopts::value<vector<string>>())
-    // keyword
-    ("h,help", "print help.")
-    ("t,trees", "specify tree name.",
-     cxxopts::value<vector<string>>()
+void resetCounters(TreeJob& job, unsigned int nSlots) {
+  job.numOfEvtBySlot         = vector<unsigned long>(nSlots, 0);
+  job.numOfEvtOkBySlot       = vector<unsigned long>(nSlots, 0);
+  job.timeBySlot             = vector<microseconds>(nSlots, microseconds(0));
+  job.cacheBySlot            = vector<TruthCache>(nSlots);
+  job.numOfEvtReusedBySlot   = vector<unsigned long>(nSlots, 0);
+  job.numOfEvtAllocBySlot    = vector<unsigned long>(nSlots, 0);
+  job.numOfSteadyAllocBySlot = vector<unsigned long>(nSlots, 0);
+  job.numOfVarFailBySlot     = vector<unsigned long>(nSlots, 0);
+}
+
+// The entry of the input tree of each candidate. 'rdfentry_' can't be used:
+// w/ implicit MT, it only counts the entries in the order the tasks are
+// scheduled.
+const auto INPUT_ENTRY_BR = string("input_entry");
+
+// Records the reader of the current task of each slot, which knows the entry
+// of the input tree being processed
+class InputEntryHelper
+    : public ROOT::Detail::RDF::RActionImpl<InputEntryHelper> {
+ public:
+  using Result_t = vector<TTreeReader*>;
+
+  explicit InputEntryHelper(shared_ptr<Result_t> readers) : readers(readers) {}
+  InputEntryHelper(InputEntryHelper&&)      = default;
+  InputEntryHelper(const InputEntryHelper&) = delete;
+
+  shared_ptr<Result_t> GetResultPtr() const { return readers; }
+  void                 Initialize() {}
+  void                 InitTask(TTreeReader* reader, unsigned int slot) {
+    (*readers)[slot] = reader;
+  }
+  void   Exec(unsigned int) {}
+  void   Finalize() {}
+  string GetActionName() { return "InputEntry"; }
+
+ private:
+  shared_ptr<Result_t> readers;
+};
+
+// NOTE: Actions only run in the first event loop of a graph, so the column is
+//       only valid there
+RNode defineInputEntry(RNode df) {
+  auto readers = make_shared<InputEntryHelper::Result_t>(df.GetNSlots());
+  auto action  = df.Book(InputEntryHelper(readers));
+  return df.DefineSlot(
+      INPUT_ENTRY_BR,
+      [readers, action](unsigned int slot) {
+        return static_cast<ULong64_t>(
+            (*readers)[slot]->GetTree()->GetReadEntry());
+      },
+      {});
+}
+
+// An input tree restricted to an entry range. The graph only references the
+// tree, so this must outlive the graph.
+struct InputTree {
+  unique_ptr<TEntryList> entries{};  // deleted after the tree it's set on
+  unique_ptr<TFile>      file{};
+  TTree*                 tree = nullptr;
+};
+
+// NOTE: The range is applied w/ an entry list, which is honored w/ and w/o
+//       implicit MT (unlike Range), and only the entries in the range are
+//       read. An empty entry list would mean all entries w/ implicit MT,
+//       hence the filter.
+RNode prepInputRange(const string ntpIn, const string tree, EntryRange range) {
+  TDirectory::TContext ctx{};
+
+  auto input  = make_shared<InputTree>();
+  input->file = unique_ptr<TFile>(TFile::Open(ntpIn.c_str()));
+  if (!input->file || input->file->IsZombie())
+    throw runtime_error("Can't open ntuple: " + ntpIn);
+  input->tree = input->file->Get<TTree>(tree.c_str());
+  if (input->tree == nullptr)
+    throw runtime_error("Can't find tree " + tree + " in " + ntpIn);
+
+  input->entries = make_unique<TEntryList>(input->tree);
+  input->entries->SetDirectory(nullptr);
+  for (auto entry = range.first; entry < range.second; entry++)
+    input->entries->Enter(entry);
+  input->tree->SetEntryList(input->entries.get());
+
+  // the filter also keeps the input tree alive
+  auto empty = range.second <= range.first;
+  return static_cast<RNode>(RDataFrame(*input->tree))
+      .Filter([input, empty] { return !empty; }, {});
+}
+
+// Input ntuple w/ aux output and HAMMER particles defined, but not reweighted
+pair<RNode, vector<string>> prepInputGraph(const string ntpIn,
+                                           const TreeJob& job) {
+  RNode df = job.partialRange
+                 ? prepInputRange(ntpIn, job.tree, job.range)
+                 : static_cast<RNode>(RDataFrame(job.tree, ntpIn));
+  vector<string> outputBrs{"runNumber", "eventNumber"};
+
+  cout << "Handling " << job.tree << " with B meson name " << job.bMeson
+       << endl;
+
+  // prepare aux output branches like q2_true
+  auto [dfAux, outputBrsAux] = prepAuxOutput(df, job.bMeson);
+  df                         = dfAux;
+  for (const auto& br : outputBrsAux) outputBrs.emplace_back(br);
+
+  // prepare HAMMER particles
+  tie(df, ignore) = prepHamInput(df, job.bMeson);
+  df = defineInputEntry(df)
+           .Define("run_number", "static_cast<UInt_t>(runNumber)")
+           .Define("event_number", "static_cast<ULong64_t>(eventNumber)");
+
+  return {df, outputBrs};
+}
+
+// Output branches of the weights, w/ their indices in 'FFResult::weights'
+vector<pair<string, size_t>> nominalWeightBrs(
+    const vector<FFVariant>& variants) {
+  auto   result = vector<pair<string, size_t>>{};
+  size_t offset = 0;
+  for (const auto& variant : variants) {
+    result.emplace_back(variant.brPrefix, offset);
+    offset += 1 + variant.numOfFFVar;
+  }
+  return result;
+}
+
+vector<pair<string, size_t>> varWeightBrs(const vector<FFVariant>& variants) {
+  auto   result = vector<pair<string, size_t>>{};
+  size_t offset = 0;
+  for (const auto& variant : variants) {
+    for (int i = 1; i <= variant.numOfFFVar; i++)
+      result.emplace_back(variant.brPrefix + "_var" + to_string(i), offset + i);
+    offset += 1 + variant.numOfFFVar;
+  }
+  return result;
+}
+
+// FF tensors are stored for at most one variant, the one w/ eigenvector
+// variations; "" if disabled
+string tensorBr(const vector<FFVariant>& variants) {
+  for (const auto& variant : variants)
+    if (variant.ffTensor) return variant.brPrefix + "_tensor";
+  return "";
+}
+
+// Names of the weight branches, by index in 'FFResult::weights'
+vector<string> weightNames(const vector<FFVariant>& variants) {
+  auto result = vector<string>(numOfWeights(variants));
+  for (const auto& [name, idx] : nominalWeightBrs(variants)) result[idx] = name;
+  for (const auto& [name, idx] : varWeightBrs(variants)) result[idx] = name;
+  return result;
+}
+
+// Weight sums w/ a deterministic reduction: a new partial sum is started at
+// each cluster of the input tree and at the start of each task (an entry range
+// of the event loop, made of whole clusters), w/ the entries of the input
+// tree. The partial sums are merged in entry order, so their boundaries only
+// depend on the input, not on the task layout, which slot ran which task, nor
+// on whether a slot ran adjacent tasks back to back.
+class WeightSumsHelper
+    : public ROOT::Detail::RDF::RActionImpl<WeightSumsHelper> {
+ public:
+  using Result_t = WeightSumsByMode;
+  typedef vector<pair<ULong64_t, WeightSumsByMode>> Partials;
+
+  WeightSumsHelper(unsigned int nSlots, vector<Long64_t> clusterStarts)
+      : sums(make_shared<WeightSumsByMode>()),
+        clusterStarts(move(clusterStarts)),
+        partialsBySlot(nSlots),
+        nextStartBySlot(nSlots, 0),
+        newTaskBySlot(nSlots, true) {}
+  WeightSumsHelper(WeightSumsHelper&&)      = default;
+  WeightSumsHelper(const WeightSumsHelper&) = delete;
+
+  shared_ptr<WeightSumsByMode> GetResultPtr() const { return sums; }
+  void                         Initialize() {}
+  void                         InitTask(TTreeReader*, unsigned int slot) {
+    newTaskBySlot[slot] = true;
+  }
+  string GetActionName() { return "WeightSums"; }
+
+  void Exec(unsigned int slot, ULong64_t entry, int dMesonId, bool isTau,
+            const FFResult* result) {
+    auto& partials  = partialsBySlot[slot];
+    auto& nextStart = nextStartBySlot[slot];
+    if (newTaskBySlot[slot] || static_cast<Long64_t>(entry) >= nextStart) {
+      partials.emplace_back(entry, WeightSumsByMode{});
+      auto next = upper_bound(clusterStarts.begin(), clusterStarts.end(),
+                              static_cast<Long64_t>(entry));
+      nextStart =
+          next == clusterStarts.end() ? numeric_limits<Long64_t>::max() : *next;
+    }
+    newTaskBySlot[slot] = false;
+    partials.back().second[{dMesonId, isTau}].add(result->weights);
+  }
+
+  void Finalize() {
+    auto partials = Partials{};
+    for (auto& slotPartials : partialsBySlot)
+      for (auto& partial : slotPartials) partials.emplace_back(move(partial));
+    sort(partials.begin(), partials.end(),
+         [](const Partials::value_type& lhs, const Partials::value_type& rhs) {
+           return lhs.first < rhs.first;
+         });
+    for (const auto& [first, partialSums] : partials)
+      mergeWeightSums(*sums, partialSums);
+  }
+
+ private:
+  shared_ptr<WeightSumsByMode> sums;
+  vector<Long64_t>             clusterStarts;
+  vector<Partials>             partialsBySlot;
+  vector<Long64_t>             nextStartBySlot;
+  vector<char>                 newTaskBySlot;  // written concurrently by slots
+};
+
+// NOTE: Lazy, filled by the event loop of the snapshot
+void bookWeightSums(RNode df, const string ntpIn, TreeJob& job) {
+  job.weightSums = df.Book<ULong64_t, int, bool, const FFResult*>(
+      WeightSumsHelper(df.GetNSlots(), clusterStarts(ntpIn, job.tree)),
+      {INPUT_ENTRY_BR, "d_meson1_true_id", "is_tau", "ff_result"});
+}
+
+RNode defineWeight(RNode df, const string name, size_t idx) {
+  return df.Define(
+      name, [idx](const FFResult* result) { return result->weights[idx]; },
+      {"ff_result"});
+}
+
+// Exact HAMMER weights as 'ff_result', w/ the counters of 'job' reset
+RNode defineFFResult(RNode df, HamPool& hams, const vector<FFVariant>& variants,
+                     TreeJob& job) {
+  resetCounters(job, hams.size());
+
+  auto reweight = reweightWrapper(
+      hams, job.numOfEvtBySlot, job.numOfEvtOkBySlot, job.timeBySlot,
+      job.cacheBySlot, job.numOfEvtReusedBySlot, job.numOfEvtAllocBySlot,
+      job.numOfSteadyAllocBySlot, job.numOfVarFailBySlot, job.prev.get(),
+      variants);
+  return df.DefineSlot(
+      "ff_result", reweight,
+      {INPUT_ENTRY_BR, "run_number", "event_number", "ham_tm_ok", "is_tau",
+       "part_B", "part_D", "part_D_dau0", "part_D_dau1", "part_D_dau2",
+       "part_L", "part_NuL", "part_Mu", "part_NuMu", "part_NuTau",
+       "part_photon_arr"});
+}
+
+// Output branches from 'ff_result'
+RNode defineFFOutput(RNode df, const vector<FFVariant>& variants,
+                     vector<string>& outputBrs) {
+  for (const auto& [outputBrName, idx] : varWeightBrs(variants)) {
+    df = defineWeight(df, outputBrName, idx);
+    outputBrs.emplace_back(outputBrName);
+  }
+  df = df.Define(
+      "ham_ok", [](const FFResult* result) { return result->hamOk; },
+      {"ff_result"});
+  outputBrs.emplace_back("ham_ok");
+  for (const auto& [outputBrName, idx] : nominalWeightBrs(variants)) {
+    df = defineWeight(df, outputBrName, idx);
+    outputBrs.emplace_back(outputBrName);
+  }
+
+  auto tensorBrName = tensorBr(variants);
+  if (tensorBrName != "") {
+    df = df.Define(
+        tensorBrName, [](const FFResult* result) { return result->ffTensor; },
+        {"ff_result"});
+    df = df.Define(
+        tensorBrName + "_decay",
+        [](const FFResult* result) { return result->ffTensorDecay; },
+        {"ff_result"});
+    outputBrs.emplace_back(tensorBrName);
+    outputBrs.emplace_back(tensorBrName + "_decay");
+  }
+
+  return df;
+}
+
+pair<RNode, vector<string>> buildReweightGraph(
+    HamPool& hams, const vector<FFVariant>& variants, const string ntpIn,
+    TreeJob& job) {
+  auto [df, outputBrs] = prepInputGraph(ntpIn, job);
+
+  // reweight FF
+  df = defineFFResult(df, hams, variants, job);
+  df = defineFFOutput(df, variants, outputBrs);
+  bookWeightSums(df, ntpIn, job);
+
+  return {df, outputBrs};
+}
+
+void printSummary(const TreeJob& job) {
+  unsigned long numOfEvt   = 0;
+  unsigned long numOfEvtOk   = 0;
+  unsigned long numOfLookups = 0;
+  unsigned long numOfHits    = 0;
+  unsigned long numOfReused  = 0;
+  unsigned long numOfAlloc   = 0;
+  unsigned long numOfSteady  = 0;
+  unsigned long numOfVarFail = 0;
+  auto          time         = microseconds(0);
+  for (unsigned int slot = 0; slot != job.numOfEvtBySlot.size(); slot++) {
+    numOfEvt += job.numOfEvtBySlot[slot];
+    numOfEvtOk += job.numOfEvtOkBySlot[slot];
+    numOfReused += job.numOfEvtReusedBySlot[slot];
+    numOfAlloc += job.numOfEvtAllocBySlot[slot];
+    numOfSteady += job.numOfSteadyAllocBySlot[slot];
+    numOfVarFail += job.numOfVarFailBySlot[slot];
+    numOfLookups += job.cacheBySlot[slot].numOfLookups;
+    numOfHits += job.cacheBySlot[slot].numOfHits;
+    time += job.timeBySlot[slot];
+  }
+
+  cout << "Summary for " << job.tree << ":" << endl;
+  cout << "Total number of candidates: " << numOfEvt << endl;
+  cout << "Hammer reweighted candidates: " << numOfEvtOk << endl;
+  cout << "Reweighted fraction: "
+       << static_cast<float>(numOfEvtOk) / static_cast<float>(numOfEvt)
+       << endl;
+  cout << "HAMMER time per reweighted candidate: "
+       << static_cast<float>(time.count()) / static_cast<float>(numOfEvtOk)
+       << " us" << endl;
+  cout << "Truth cache hits: " << numOfHits << " ("
+       << static_cast<float>(numOfHits) / static_cast<float>(numOfLookups)
+       << " of truth-matched candidates)" << endl;
+  if (numOfVarFail > 0)
+    cout << "  WARN: Candidates w/ failed FF variations (NaN weights): "
+         << numOfVarFail << endl;
+  if (job.prev)
+    cout << "Candidates reused from previous output: " << numOfReused << endl;
+#ifdef COUNT_HEAP_ALLOCS
+  // only new decay topologies and events w/ more candidates than before should
+  // allocate, while warming up the buffers
+  cout << "Candidates w/ heap allocations outside of HAMMER: " << numOfAlloc
+       << endl;
+  cout << "After the first " << ALLOC_WARM_UP_NUM_OF_CANDS
+       << " candidates of each slot: " << numOfSteady << endl;
+#endif
+}
+
+void reweightTree(HamPool& hams, const vector<FFVariant>& variants,
+                  const string ntpIn, const string ntpOut, TreeJob& job) {
+  auto [df, outputBrs] = buildReweightGraph(hams, variants, ntpIn, job);
+
+  // output option
+  auto writeOpts  = ROOT::RDF::RSnapshotOptions{};
+  writeOpts.fMode = "UPDATE";
+
+  df.Snapshot(job.tree, ntpOut, outputBrs, writeOpts);
+  writeEntryRange(ntpOut, job.tree, job.range);
+  writeWeightSums(ntpOut, job.tree, weightNames(variants), *job.weightSums);
+
+  printSummary(job);
+}
+
+// With implicit MT, Snapshot writes entries in the order the slots finish. The
+// input entry numbers are then written as well, to restore the input order
+// when copying the tree to the output.
+auto snapshotWithEntries(RNode df, const string tree, const string ntpTmp,
+                         vector<string> outputBrs, bool lazy) {
+  auto writeOpts  = ROOT::RDF::RSnapshotOptions{};
+  writeOpts.fLazy = lazy;
+
+  outputBrs.emplace_back(INPUT_ENTRY_BR);
+  return df.Snapshot(tree, ntpTmp, outputBrs, writeOpts);
+}
+
+// Schedule all trees in a single run of the implicit MT pool, each w/ its own
+// HAMMER instances. As concurrent writes to the same file are not allowed, each
+// tree is first written to a temporary file.
+void reweightTreesConcurrently(vector<HamPool>&         hamPools,
+                               const vector<FFVariant>& variants,
+                               const string ntpIn, const string ntpOut,
+                               vector<TreeJob>& jobs) {
+  auto ntpTmps = vector<string>{};
+  auto handles = vector<ROOT::RDF::RResultHandle>{};
+  for (int idx = 0; idx != jobs.size(); idx++) {
+    auto ntpTmp = ntpOut + ".tree" + to_string(idx);
+    auto [df, outputBrs] =
+        buildReweightGraph(hamPools[idx], variants, ntpIn, jobs[idx]);
+
+    handles.emplace_back(
+        snapshotWithEntries(df, jobs[idx].tree, ntpTmp, outputBrs, true));
+    ntpTmps.emplace_back(ntpTmp);
+  }
+
+  ROOT::RDF::RunGraphs(handles);
+
+  // single output session
+  auto outputFile = unique_ptr<TFile>(TFile::Open(ntpOut.c_str(), "UPDATE"));
+  for (int idx = 0; idx != jobs.size(); idx++) {
+    copyTreeInEntryOrder(outputFile.get(), ntpTmps[idx], jobs[idx].tree,
+                         INPUT_ENTRY_BR);
+    writeEntryRange(outputFile.get(), jobs[idx].tree, jobs[idx].range);
+    writeWeightSums(outputFile.get(), jobs[idx].tree, weightNames(variants),
+                    *jobs[idx].weightSums);
+    printSummary(jobs[idx]);
+  }
+  outputFile->Close();
+
+  for (const auto& tmp : ntpTmps) remove(tmp.c_str());
+}
+
+// The aux branches (runNumber, q2_true, ...) are written w/ the types of their
+// columns, as by Snapshot. These are only known at runtime, so the values
+// travel through the pipeline as raw bits, and are written w/ the matching
+// leaf types.
+typedef array<ULong64_t, PIPELINE_MAX_NUM_OF_AUX_BRS> AuxBits;
+
+// Calls 'func' w/ a value of the scalar column type 'type', and the leaf type
+// code of that type
+template <typename Func>
+void visitScalarType(const string& type, Func func) {
+  if (type == "bool" || type == "Bool_t") return func(bool{}, "O");
+  if (type == "char" || type == "Char_t") return func(Char_t{}, "B");
+  if (type == "unsigned char" || type == "UChar_t")
+    return func(UChar_t{}, "b");
+  if (type == "short" || type == "Short_t") return func(Short_t{}, "S");
+  if (type == "unsigned short" || type == "UShort_t")
+    return func(UShort_t{}, "s");
+  if (type == "int" || type == "Int_t") return func(Int_t{}, "I");
+  if (type == "unsigned int" || type == "UInt_t") return func(UInt_t{}, "i");
+  if (type == "long" || type == "Long_t") return func(Long_t{}, "G");
+  if (type == "unsigned long" || type == "ULong_t")
+    return func(ULong_t{}, "g");
+  if (type == "Long64_t" || type == "long long") return func(Long64_t{}, "L");
+  if (type == "ULong64_t" || type == "unsigned long long")
+    return func(ULong64_t{}, "l");
+  if (type == "float" || type == "Float_t") return func(Float_t{}, "F");
+  if (type == "double" || type == "Double_t") return func(Double_t{}, "D");
+  throw runtime_error("Unsupported type of aux branch: " + type);
+}
+
+// Pack the aux columns into a single 'pipeline_aux' column, one by one
+RNode defineAuxBits(RNode df, const vector<string>& auxBrs,
+                    const vector<string>& auxTypes) {
+  if (auxBrs.size() > PIPELINE_MAX_NUM_OF_AUX_BRS)
+    throw runtime_error("Too many aux branches for the pipeline");
+
+  auto prev = string("pipeline_aux0");
+  df        = df.Define(prev, [] { return AuxBits{}; }, {});
+  for (size_t idx = 0; idx != auxBrs.size(); idx++) {
+    auto name = "pipeline_aux" + to_string(idx + 1);
+    visitScalarType(auxTypes[idx], [&](auto zero, const char*) {
+      df = df.Define(
+          name,
+          [idx](const AuxBits& bits, decltype(zero) val) {
+            auto result = bits;
+            memcpy(&result[idx], &val, sizeof(val));
+            return result;
+          },
+          {prev, auxBrs[idx]});
+    });
+    prev = name;
+  }
+  return df.Alias("pipeline_aux", prev);
+}
+
+// A candidate travelling through the pipeline. The aux branches are packed in
+// 'aux'; the fields below it are the ones needed for reweighting.
+struct CandRecord {
+  ULong64_t seq;  // position in the pipeline, for restoring the input order
+
+  AuxBits   aux;
+  UInt_t    runNumber;
+  ULong64_t eventNumber;
+  bool      isTau;
+  int       dMeson1Id;
+  bool      tmOk;
+
+  ULong64_t          entry;
+  HamPartCtn         pB, pD, pDDau0, pDDau1, pDDau2, pL, pNuL, pMu, pNuMu,
+      pNuTau;
+  PhotonArr          pPhotons;
+
+  bool           hamOk;
+  vector<double> weights;
+  vector<double> ffTensor;
+  string         ffTensorDecay;
+};
+
+typedef BoundedQueue<unique_ptr<CandRecord>> CandQueue;
+typedef vector<unique_ptr<CandRecord>>       CandChunk;
+typedef WorkStealingDeques<CandChunk>        CandChunkDeques;
+
+// HAMMER caches amplitudes and rates per process signature, so candidates w/
+// the same decay topology are best reweighted back to back
+typedef array<int, 6> CandTopology;
+
+CandTopology candTopology(const CandRecord& cand) {
+  return {get<4>(cand.pB),     get<4>(cand.pD),     cand.isTau,
+          get<4>(cand.pDDau0), get<4>(cand.pDDau1), get<4>(cand.pDDau2)};
+}
+
+// Sort a batch by topology and cut it into chunks of a single topology each.
+// The sort is stable, so candidates of the same MC event stay adjacent for the
+// truth cache.
+void dealBatch(CandChunk& batch, CandChunkDeques& inputChunks) {
+  stable_sort(batch.begin(), batch.end(),
+              [](const unique_ptr<CandRecord>& lhs,
+                 const unique_ptr<CandRecord>& rhs) {
+                return candTopology(*lhs) < candTopology(*rhs);
+              });
+
+  auto chunk = CandChunk{};
+  for (auto& cand : batch) {
+    bool full = chunk.size() >= PIPELINE_CHUNK_SIZE;
+    if (!chunk.empty() &&
+        (full || candTopology(*chunk.back()) != candTopology(*cand))) {
+      inputChunks.push(move(chunk));
+      chunk = CandChunk{};
+    }
+    chunk.emplace_back(move(cand));
+  }
+  if (!chunk.empty()) inputChunks.push(move(chunk));
+  batch.clear();
+}
+
+// Reader -> (work-stealing deques) -> HAMMER workers -> (queue) -> writer.
+// The reader buffers batches of candidates, sorted by topology, and deals them
+// in small chunks to the workers; as the cost per candidate varies a lot, idle
+// workers steal chunks from busy ones.
+// The reader never runs more than PIPELINE_WINDOW_SIZE candidates ahead of the
+// writer, which caps both memory and the size of the writer's reorder buffer.
+void reweightTreePipelined(HamPool& hams, const vector<FFVariant>& variants,
+                           const string ntpIn, const string ntpOut,
+                           TreeJob& job) {
+  auto nWorkers = hams.size();
+  resetCounters(job, nWorkers);
+
+  auto inputChunks  = CandChunkDeques(nWorkers);
+  auto outputQueue  = CandQueue(PIPELINE_QUEUE_SIZE);
+  auto numOfWritten = atomic<ULong64_t>{0};
+  auto windowOpen   = IdleWait{};
+
+  // the graph is built upfront, as the writer needs the aux column types
+  auto input    = prepInputGraph(ntpIn, job);
+  auto auxBrs   = input.second;
+  auto auxTypes = vector<string>{};
+  for (const auto& br : auxBrs)
+    auxTypes.emplace_back(input.first.GetColumnType(br));
+  auto df = defineAuxBits(input.first, auxBrs, auxTypes);
+
+  // reader
+  auto reader = thread([&] {
+    ULong64_t seq   = 0;
+    auto      batch = CandChunk{};
+    df.Foreach(
+        [&](ULong64_t entry, const AuxBits& aux, UInt_t runNumber,
+            ULong64_t eventNumber, bool isTau, int dMeson1Id, bool tmOk,
+            HamPartCtn pB, HamPartCtn pD, HamPartCtn pDDau0,
+            HamPartCtn pDDau1, HamPartCtn pDDau2, HamPartCtn pL,
+            HamPartCtn pNuL, HamPartCtn pMu, HamPartCtn pNuMu,
+            HamPartCtn pNuTau, const PhotonArr& pPhotons) {
+          // NOTE: The pending batch must be dealt before waiting, otherwise
+          //       the writer may wait for a candidate in it
+          if (seq >= numOfWritten.load() + PIPELINE_WINDOW_SIZE &&
+              !batch.empty())
+            dealBatch(batch, inputChunks);
+          if (seq >= numOfWritten.load() + PIPELINE_WINDOW_SIZE)
+            windowOpen.wait([&] {
+              return seq < numOfWritten.load() + PIPELINE_WINDOW_SIZE;
+            });
+
+          auto cand = unique_ptr<CandRecord>(new CandRecord{
+              seq++, aux, runNumber, eventNumber, isTau, dMeson1Id, tmOk,
+              entry, pB, pD, pDDau0, pDDau1, pDDau2, pL, pNuL, pMu, pNuMu,
+              pNuTau, pPhotons});
+          batch.emplace_back(move(cand));
+          if (batch.size() >= PIPELINE_BATCH_SIZE)
+            dealBatch(batch, inputChunks);
+        },
+        {INPUT_ENTRY_BR, "pipeline_aux", "run_number", "event_number",
+         "is_tau", "d_meson1_true_id", "ham_tm_ok", "part_B", "part_D",
+         "part_D_dau0",
+         "part_D_dau1", "part_D_dau2", "part_L", "part_NuL", "part_Mu",
+         "part_NuMu", "part_NuTau", "part_photon_arr"});
+
+    if (!batch.empty()) dealBatch(batch, inputChunks);
+    inputChunks.close();
+  });
+
+  // HAMMER workers
+  auto reweight =
+      reweightWrapper(hams, job.numOfEvtBySlot, job.numOfEvtOkBySlot,
+                      job.timeBySlot, job.cacheBySlot,
+                      job.numOfEvtReusedBySlot, job.numOfEvtAllocBySlot,
+                      job.numOfSteadyAllocBySlot, job.numOfVarFailBySlot,
+                      job.prev.get(), variants);
+  auto workers          = vector<thread>{};
+  auto numOfWorkersDone = atomic<unsigned int>{0};
+  for (unsigned int slot = 0; slot != nWorkers; slot++) {
+    workers.emplace_back([&, slot] {
+      auto chunk = CandChunk{};
+      while (inputChunks.pop(slot, chunk)) {
+        for (auto& cand : chunk) {
+          auto result = reweight(
+              slot, cand->entry, cand->runNumber, cand->eventNumber, cand->tmOk,
+              cand->isTau, cand->pB, cand->pD, cand->pDDau0, cand->pDDau1,
+              cand->pDDau2, cand->pL, cand->pNuL, cand->pMu, cand->pNuMu,
+              cand->pNuTau, cand->pPhotons);
+          cand->hamOk         = result->hamOk;
+          cand->weights       = result->weights;
+          cand->ffTensor      = result->ffTensor;
+          cand->ffTensorDecay = result->ffTensorDecay;
+          outputQueue.push(move(cand));
+        }
+      }
+      if (++numOfWorkersDone == nWorkers) outputQueue.close();
+    });
+  }
+
+  // writer, restores the input order before filling the output tree
+  auto writer = thread([&] {
+    auto outputFile = unique_ptr<TFile>(TFile::Open(ntpOut.c_str(), "UPDATE"));
+    auto dir        = dirname(job.tree);
+    if (dir != "" && !outputFile->GetDirectory(dir)) outputFile->mkdir(dir);
+    outputFile->cd(dir);
+
+    auto cand       = unique_ptr<CandRecord>{};
+    auto rec        = CandRecord{};
+    auto outputTree = new TTree(basename(job.tree), basename(job.tree));
+    // the leaves read their values from the start of the bits, where they
+    // are packed
+    for (size_t idx = 0; idx != auxBrs.size(); idx++)
+      visitScalarType(auxTypes[idx], [&](auto, const char* code) {
+        outputTree->Branch(auxBrs[idx].c_str(), &rec.aux[idx],
+                           (auxBrs[idx] + "/" + code).c_str());
+      });
+    // the candidates' weights are moved in, so the branches are bound to a
+    // separate buffer
+    auto weights = vector<double>(numOfWeights(variants));
+    for (const auto& [outputBrName, idx] : varWeightBrs(variants))
+      outputTree->Branch(outputBrName.c_str(), &weights[idx]);
+    outputTree->Branch("ham_ok", &rec.hamOk);
+    for (const auto& [outputBrName, idx] : nominalWeightBrs(variants))
+      outputTree->Branch(outputBrName.c_str(), &weights[idx]);
+    auto tensorBrName = tensorBr(variants);
+    if (tensorBrName != "") {
+      outputTree->Branch(tensorBrName.c_str(), &rec.ffTensor);
+      outputTree->Branch((tensorBrName + "_decay").c_str(),
+                         &rec.ffTensorDecay);
+    }
+
+    // in input order, so the sums are the same as in a single thread
+    auto weightSums = WeightSumsByMode{};
+    auto pending    = vector<unique_ptr<CandRecord>>(PIPELINE_WINDOW_SIZE);
+    while (outputQueue.pop(cand)) {
+      auto seq                            = cand->seq;
+      pending[seq % PIPELINE_WINDOW_SIZE] = move(cand);
+
+      for (;;) {
+        auto& next = pending[numOfWritten.load() % PIPELINE_WINDOW_SIZE];
+        if (!next || next->seq != numOfWritten.load()) break;
+        rec = move(*next);
+        copy(rec.weights.begin(), rec.weights.end(), weights.begin());
+        weightSums[{rec.dMeson1Id, rec.isTau}].add(rec.weights);
+        outputTree->Fill();
+        next.reset();
+        numOfWritten++;
+      }
+      windowOpen.notifyOne();
+    }
+
+    outputTree->Write(nullptr, TObject::kOverwrite);
+    writeEntryRange(outputFile.get(), job.tree, job.range);
+    writeWeightSums(outputFile.get(), job.tree, weightNames(variants),
+                    weightSums);
+    outputFile->Close();
+  });
+
+  reader.join();
+  for (auto& w : workers) w.join();
+  writer.join();
+
+  printSummary(job);
+}
+
+// Fork workers after HAMMER is fully initialized so that they share its pages
+// copy-on-write; each worker reweights a contiguous part of the entry range of
+// every tree
+int reweightForked(HamPool& hams, const vector<FFVariant>& variants,
+                   const string ntpIn, const string ntpOut,
+                   const vector<TreeJob>& jobs, unsigned int nProcs) {
+  auto ntpParts = vector<string>{};
+  auto pids     = vector<pid_t>{};
+  for (unsigned int w = 0; w != nProcs; w++) {
+    // partial outputs of a failed run would make Snapshot fail on the trees
+    auto ntpPart = ntpOut + ".worker" + to_string(w);
+    ntpParts.emplace_back(ntpPart);
+    remove(ntpPart.c_str());
+
+    fflush(stdout);
+    auto pid = fork();
+    if (pid < 0) {
+      cout << "ERROR: Failed to fork worker " << w << endl;
+      return 1;
+    }
+
+    if (pid == 0) {
+      int exitCode = 0;
+      try {
+        for (auto job : jobs) {
+          job.range      = shardRange(job.range, w, nProcs);
+          job.partialRange = true;
+          cout << "Worker " << w << " handling entries [" << job.range.first
+               << ", " << job.range.second << ")" << endl;
+          reweightTree(hams, variants, ntpIn, ntpPart, job);
+        }
+      } catch (const exception& e) {
+        cout << "ERROR: Worker " << w << " failed: " << e.what() << endl;
+        exitCode = 1;
+      }
+      fflush(stdout);
+      _exit(exitCode);
+    }
+
+    pids.emplace_back(pid);
+  }
+
+  bool allOk = true;
+  for (auto pid : pids) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) allOk = false;
+  }
+  if (!allOk) {
+    cout << "ERROR: Some workers failed, partial outputs are kept." << endl;
+    return 1;
+  }
+
+  auto trees = vector<string>{};
+  for (const auto& job : jobs) trees.emplace_back(job.tree);
+  mergeShards(ntpParts, ntpOut, trees);
+  for (const auto& part : ntpParts) remove(part.c_str());
+
+  return 0;
+}
+
+/////////////////////////////
+// Incremental reweighting //
+/////////////////////////////
+
+// A candidate is identified by its event and its position among the candidates
+// of that event, which is stable as long as a top-up production only adds MC
+typedef tuple<UInt_t, ULong64_t, unsigned int> CandKey;
+
+vector<CandKey> readCandKeys(const string ntp, const string tree) {
+  auto ids = vector<pair<UInt_t, ULong64_t>>(getEntries(ntp, tree));
+  auto df  = static_cast<RNode>(RDataFrame(tree, ntp));
+  defineInputEntry(df)
+      .Define("run_number", "static_cast<UInt_t>(runNumber)")
+      .Define("event_number", "static_cast<ULong64_t>(eventNumber)")
+      .Foreach(
+          [&](ULong64_t entry, UInt_t runNumber, ULong64_t eventNumber) {
+            ids[entry] = {runNumber, eventNumber};
+          },
+          {INPUT_ENTRY_BR, "run_number", "event_number"});
+
+  auto numOfCands = map<pair<UInt_t, ULong64_t>, unsigned int>{};
+  auto keys       = vector<CandKey>{};
+  for (const auto& [runNumber, eventNumber] : ids)
+    keys.emplace_back(runNumber, eventNumber,
+                      numOfCands[{runNumber, eventNumber}]++);
+  return keys;
+}
+
+// The previous output must have the branches of the current variants
+vector<FFResult> readPrevResults(const string ntp, const string tree,
+                                 const vector<FFVariant>& variants) {
+  auto file = unique_ptr<TFile>(TFile::Open(ntp.c_str()));
+  if (!file || file->IsZombie())
+    throw runtime_error("Can't open previous output: " + ntp);
+  auto prevTree = file->Get<TTree>(tree.c_str());
+  if (prevTree == nullptr)
+    throw runtime_error("Can't find tree " + tree + " in " + ntp);
+
+  auto result = FFResult{false, vector<double>(numOfWeights(variants), 1.0)};
+  auto bind   = [&](const string br, auto addr) {
+    if (prevTree->GetBranch(br.c_str()) == nullptr)
+      throw runtime_error("No branch " + br + " in previous output " + ntp);
+    prevTree->SetBranchAddress(br.c_str(), addr);
+  };
+
+  auto tensor      = &result.ffTensor;
+  auto tensorDecay = &result.ffTensorDecay;
+  bind("ham_ok", &result.hamOk);
+  for (const auto& [br, idx] : nominalWeightBrs(variants))
+    bind(br, &result.weights[idx]);
+  for (const auto& [br, idx] : varWeightBrs(variants))
+    bind(br, &result.weights[idx]);
+  if (tensorBr(variants) != "") {
+    bind(tensorBr(variants), &tensor);
+    bind(tensorBr(variants) + "_decay", &tensorDecay);
+  }
+
+  auto results = vector<FFResult>{};
+  for (Long64_t entry = 0; entry != prevTree->GetEntries(); entry++) {
+    prevTree->GetEntry(entry);
+    results.emplace_back(result);
+  }
+  return results;
+}
+
+// The positions of the candidates among the candidates of their events are
+// taken from the entry order of the previous output, so it must be in input
+// entry order, and start at the first input entry. All outputs are written in
+// input entry order (also w/ '-j', '-p' and '--pipeline') and labeled w/ their
+// entry range, so outputs w/o the labels (e.g. from older versions) are
+// refused.
+void checkPrevOrder(const string ntpPrev, const string tree) {
+  auto range = EntryRange{};
+  try {
+    range = readEntryRange(ntpPrev, tree);
+  } catch (const runtime_error&) {
+    throw runtime_error("Previous output " + ntpPrev +
+                        " has no entry range for " + tree +
+                        ", so its entry order can't be trusted");
+  }
+
+  auto [first, last] = range;
+  if (first != 0)
+    throw runtime_error("Previous output " + ntpPrev + " of " + tree +
+                        " doesn't start at the first input entry");
+  if (last - first != getEntries(ntpPrev, tree))
+    throw runtime_error("Previous output " + ntpPrev + " of " + tree +
+                        " doesn't match its entry range");
+}
+
+// Match the candidates of the input to the ones of the previous output
+shared_ptr<const PrevResults> loadPrevResults(
+    const string ntpIn, const string ntpPrev, const string tree,
+    const vector<FFVariant>& variants) {
+  checkPrevOrder(ntpPrev, tree);
+  auto prevKeys       = readCandKeys(ntpPrev, tree);
+  auto prevEntryByKey = map<CandKey, Long64_t>{};
+  for (Long64_t idx = 0; idx != prevKeys.size(); idx++)
+    prevEntryByKey[prevKeys[idx]] = idx;
+
+  auto prev     = make_shared<PrevResults>();
+  prev->results = readPrevResults(ntpPrev, tree, variants);
+  for (const auto& key : readCandKeys(ntpIn, tree)) {
+    auto match = prevEntryByKey.find(key);
+    prev->prevEntries.emplace_back(
+        match != prevEntryByKey.end() ? match->second : -1);
+  }
+  return prev;
+}
+
+///////////////////////
+// Surrogate weights //
+///////////////////////
+
+// Instead of running HAMMER on every candidate, the weights can be interpolated
+// on a grid of the helicity variables, w/ one grid per decay mode. HAMMER is
+// run once on an event at each node of the grids, and the interpolated weights
+// are checked against the exact weights of a holdout subsample.
+// NOTE: The node events have the nominal masses (so D** widths are ignored),
+//       and no FSR photons. For tau modes, the helicity variables are those of
+//       the tau, which is left undecayed in the node events. The node weights
+//       are then the exact weights averaged over the tau decay kinematics,
+//       which the holdout errors of tau modes reflect.
+
+// The D daughters HAMMER sees in 'reweightWrapper'
+vector<HamPartCtn> hamDDaus(const HamPartCtn& pD, const HamPartCtn& pDDau0,
+                            const HamPartCtn& pDDau1,
+                            const HamPartCtn& pDDau2) {
+  auto result = vector<HamPartCtn>{};
+  if (!isDstMeson(get<4>(pD))) return result;
+  for (const auto& p : {pDDau0, pDDau1, pDDau2})
+    if (get<4>(p) != 0 && get<4>(p) != 22) result.emplace_back(p);
+  return result;
+}
+
+// The HAMMER decay w/ the absolute IDs of the B, the D and the D daughters,
+// e.g. 'BD*MuNu_511_413_421_211', as the node events are built from them. ""
+// if unknown to HAMMER.
+string surrogateMode(bool isTau, const HamPartCtn& pB, const HamPartCtn& pD,
+                     const vector<HamPartCtn>& pDDaus) {
+  auto result = hamDecay(get<4>(pB), get<4>(pD), isTau);
+  if (result == "") return result;
+  for (const auto& p : {pB, pD})
+    result += "_" + to_string(TMath::Abs(get<4>(p)));
+  for (const auto& p : pDDaus)
+    result += "_" + to_string(TMath::Abs(get<4>(p)));
+  return result;
+}
+
+// (q2 [GeV^2], cos theta_l, cos theta_V, chi) from the true 4-momenta in MeV.
+// Decays w/o a D daughter have theta_V = pi/2 and chi = 0.
+GridVars helicityVars(const HamPartCtn& pB, const HamPartCtn& pD,
+                      const HamPartCtn& pL, const HamPartCtn& pNuL,
+                      const HamPartCtn& pDDau) {
+  auto toLV = [](const HamPartCtn& p) {
+    return TLorentzVector(get<1>(p), get<2>(p), get<3>(p), get<0>(p));
+  };
+  auto toBRest = -toLV(pB).BoostVector();
+  auto d       = toLV(pD);
+  auto l       = toLV(pL);
+  auto nu      = toLV(pNuL);
+  auto dDau    = toLV(pDDau);
+  for (auto p : {&d, &l, &nu, &dDau}) p->Boost(toBRest);
+
+  auto w  = l + nu;
+  auto q2 = w.M2() / 1e6;
+
+  // theta_l: the lepton in the W rest frame w.r.t. the W direction
+  auto lInW = l;
+  lInW.Boost(-w.BoostVector());
+  auto cosThetaL = TMath::Cos(lInW.Angle(w.Vect()));
+  if (get<4>(pDDau) == 0) return {q2, cosThetaL, 0.0, 0.0};
+
+  // theta_V: the D daughter in the D rest frame w.r.t. the D direction
+  auto dDauInD = dDau;
+  dDauInD.Boost(-d.BoostVector());
+  auto cosThetaV = TMath::Cos(dDauInD.Angle(d.Vect()));
+
+  // chi: between the lepton and the D decay planes
+  auto axis  = d.Vect().Unit();
+  auto normL = axis.Cross(l.Vect()).Unit();
+  auto normV = axis.Cross(dDau.Vect()).Unit();
+  auto chi   = TMath::ATan2(normL.Cross(normV).Dot(axis), normL.Dot(normV));
+
+  return {q2, cosThetaL, cosThetaV, chi};
+}
+
+// Define 'surrogate_d_daus', 'surrogate_mode' and 'surrogate_vars'
+RNode defineSurrogateInput(RNode df) {
+  df = df.Define("surrogate_d_daus", hamDDaus,
+                 {"part_D", "part_D_dau0", "part_D_dau1", "part_D_dau2"});
+  df = df.Define("surrogate_mode", surrogateMode,
+                 {"is_tau", "part_B", "part_D", "surrogate_d_daus"});
+  return df.Define(
+      "surrogate_vars",
+      [](const HamPartCtn& pB, const HamPartCtn& pD, const HamPartCtn& pL,
+         const HamPartCtn& pNuL, const vector<HamPartCtn>& pDDaus) {
+        auto pDDau =
+            pDDaus.empty() ? HamPartCtn{0.0, 0.0, 0.0, 0.0, 0} : pDDaus[0];
+        return helicityVars(pB, pD, pL, pNuL, pDDau);
+      },
+      {"part_B", "part_D", "part_L", "part_NuL", "surrogate_d_daus"});
+}
+
+// The IDs of the first candidate (by input entry) of a mode, from which the
+// node events of its grid are built
+struct SurrogateMode {
+  Long64_t    entry = -1;
+  int         bId   = 0;
+  int         dId   = 0;
+  int         lId   = 0;
+  int         nuId  = 0;
+  vector<int> dDauIds{};
+};
+
+// Modes already found in previous trees are kept
+void findSurrogateModes(map<string, SurrogateMode>& modes, const string ntpIn,
+                        const TreeJob& job) {
+  auto [df, ignored] = prepInputGraph(ntpIn, job);
+  df = defineSurrogateInput(df);
+
+  auto modesBySlot = vector<map<string, SurrogateMode>>(df.GetNSlots());
+  df.ForeachSlot(
+      [&](unsigned int slot, ULong64_t entry, bool truthMatchOk,
+          const string& name, const HamPartCtn& pB, const HamPartCtn& pD,
+          const HamPartCtn& pL, const HamPartCtn& pNuL,
+          const vector<HamPartCtn>& pDDaus) {
+        if (!truthMatchOk || name == "") return;
+        auto& mode = modesBySlot[slot][name];
+        if (mode.entry >= 0 && mode.entry < static_cast<Long64_t>(entry))
+          return;
+        mode = SurrogateMode{static_cast<Long64_t>(entry), get<4>(pB),
+                             get<4>(pD), get<4>(pL), get<4>(pNuL)};
+        for (const auto& p : pDDaus) mode.dDauIds.emplace_back(get<4>(p));
+      },
+      {INPUT_ENTRY_BR, "ham_tm_ok", "surrogate_mode", "part_B", "part_D",
+       "part_L", "part_NuL", "surrogate_d_daus"});
+
+  auto modesOfTree = map<string, SurrogateMode>{};
+  for (const auto& modesOfSlot : modesBySlot) {
+    for (const auto& [name, mode] : modesOfSlot) {
+      auto& first = modesOfTree[name];
+      if (first.entry < 0 || mode.entry < first.entry) first = mode;
+    }
+  }
+  for (const auto& [name, mode] : modesOfTree) modes.emplace(name, mode);
+}
+
+// Nominal mass in MeV
+double pdgMass(int id) {
+  auto part = TDatabasePDG::Instance()->GetParticle(id);
+  if (part == nullptr)
+    throw runtime_error("Unknown particle ID: " + to_string(id));
+  return part->Mass() * 1000;
+}
+
+// Momentum of the daughters of a 2-body decay in the rest frame of the mother
+double decayMomentum(double m, double m1, double m2) {
+  auto lambda =
+      (m * m - (m1 + m2) * (m1 + m2)) * (m * m - (m1 - m2) * (m1 - m2));
+  return TMath::Sqrt(max(lambda, 0.0)) / (2 * m);
+}
+
+struct NodeMasses {
+  double         b, d, l, nuL;
+  vector<double> dDaus;
+};
+
+NodeMasses nodeMasses(const SurrogateMode& mode) {
+  auto masses = NodeMasses{pdgMass(mode.bId), pdgMass(mode.dId),
+                           pdgMass(mode.lId), pdgMass(mode.nuId)};
+  for (auto id : mode.dDauIds) masses.dDaus.emplace_back(pdgMass(id));
+  return masses;
+}
+
+// The B, D, lepton, neutrino and D daughters (placeholders if the mode doesn't
+// have 2 of them) of the event at a node, in MeV, in the B rest frame. The D
+// flies along +z, the lepton is in the x-z plane w/ a positive x, and the
+// first D daughter at an azimuth of chi, which inverts 'helicityVars'. q2 is
+// clamped into the physical range, w/ a margin so that no particle is at rest.
+array<HamPartCtn, 6> nodeParts(const SurrogateMode& mode,
+                               const NodeMasses& masses, const GridVars& vars) {
+  auto [q2, cosThetaL, cosThetaV, chi] = vars;
+  auto q2Min  = (masses.l + masses.nuL) * (masses.l + masses.nuL);
+  auto q2Max  = (masses.b - masses.d) * (masses.b - masses.d);
+  auto margin = 1e-3 * (q2Max - q2Min);
+  auto mW = TMath::Sqrt(min(max(q2 * 1e6, q2Min + margin), q2Max - margin));
+
+  auto b    = TLorentzVector(0.0, 0.0, 0.0, masses.b);
+  auto pD   = decayMomentum(masses.b, masses.d, mW);
+  auto d    = TLorentzVector(0.0, 0.0, pD, TMath::Hypot(pD, masses.d));
+  auto w    = b - d;
+  auto toW  = w.BoostVector();
+  auto toD  = d.BoostVector();
+  auto none = HamPartCtn{0.0, 0.0, 0.0, 0.0, 0};
+  auto toPart = [](const TLorentzVector& p, int id) {
+    return HamPartCtn{p.E(), p.Px(), p.Py(), p.Pz(), id};
+  };
+
+  // the lepton in the W rest frame, at theta_l w.r.t. the W direction (-z)
+  auto pL        = decayMomentum(mW, masses.l, masses.nuL);
+  auto sinThetaL = TMath::Sqrt(max(1 - cosThetaL * cosThetaL, 0.0));
+  auto l  = TLorentzVector(pL * sinThetaL, 0.0, -pL * cosThetaL,
+                           TMath::Hypot(pL, masses.l));
+  auto nu = TLorentzVector(-l.Vect(), TMath::Hypot(pL, masses.nuL));
+  l.Boost(toW);
+  nu.Boost(toW);
+
+  auto result = array<HamPartCtn, 6>{toPart(b, mode.bId), toPart(d, mode.dId),
+                                     toPart(l, mode.lId),
+                                     toPart(nu, mode.nuId), none, none};
+  if (mode.dDauIds.size() != 2) return result;
+
+  // the D daughters in the D rest frame, the first one at theta_V w.r.t. the
+  // D direction (+z)
+  auto pDau      = decayMomentum(masses.d, masses.dDaus[0], masses.dDaus[1]);
+  auto sinThetaV = TMath::Sqrt(max(1 - cosThetaV * cosThetaV, 0.0));
+  auto dau0      = TLorentzVector(
+      pDau * sinThetaV * TMath::Cos(chi), pDau * sinThetaV * TMath::Sin(chi),
+      pDau * cosThetaV, TMath::Hypot(pDau, masses.dDaus[0]));
+  auto dau1 = TLorentzVector(-dau0.Vect(), TMath::Hypot(pDau, masses.dDaus[1]));
+  dau0.Boost(toD);
+  dau1.Boost(toD);
+
+  result[4] = toPart(dau0, mode.dDauIds[0]);
+  result[5] = toPart(dau1, mode.dDauIds[1]);
+  return result;
+}
+
+// HAMMER weights at all nodes of the grid of a mode, w/ a thread per HAMMER
+// instance. The weights of modes w/o D daughters don't depend on theta_V and
+// chi, so only their nodes at the first theta_V and chi are computed.
+SurrogateGrid evalSurrogateNodes(HamPool&                 hams,
+                                 const vector<FFVariant>& variants,
+                                 const string&            name,
+                                 const SurrogateMode&     mode) {
+  auto masses = nodeMasses(mode);
+  auto job    = TreeJob{};
+  job.tree    = "surrogate grid of " + name;
+  resetCounters(job, hams.size());
+  auto reweight =
+      reweightWrapper(hams, job.numOfEvtBySlot, job.numOfEvtOkBySlot,
+                      job.timeBySlot, job.cacheBySlot,
+                      job.numOfEvtReusedBySlot, job.numOfEvtAllocBySlot,
+                      job.numOfSteadyAllocBySlot, job.numOfVarFailBySlot,
+                      nullptr, variants);
+
+  auto grid       = SurrogateGrid(numOfWeights(variants));
+  auto numOfNodes = SurrogateGrid::numOfNodes();
+  auto angleNodes =
+      SURROGATE_AXES[2].numOfNodes * SURROGATE_AXES[3].numOfNodes;
+  bool hasDDaus = mode.dDauIds.size() == 2;
+
+  // each node is a separate event for the truth cache
+  auto workers = vector<thread>{};
+  for (unsigned int slot = 0; slot != hams.size(); slot++) {
+    workers.emplace_back([&, slot] {
+      auto none = HamPartCtn{0.0, 0.0, 0.0, 0.0, 0};
+      for (size_t node = slot; node < numOfNodes; node += hams.size()) {
+        if (!hasDDaus && node % angleNodes != 0) continue;
+        auto [pB, pD, pL, pNuL, pDDau0, pDDau1] =
+            nodeParts(mode, masses, SurrogateGrid::nodeVars(node));
+        auto result =
+            reweight(slot, node, 0, node, true, false, pB, pD, pDDau0, pDDau1,
+                     none, pL, pNuL, none, none, none, PhotonArr{});
+        if (result->hamOk) grid.set(node, result->weights);
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+
+  if (!hasDDaus) {
+    for (size_t node = 0; node != numOfNodes; node++) {
+      auto first = node - node % angleNodes;
+      if (node == first || !grid.filled[first]) continue;
+      copy_n(grid.values.begin() + first * grid.numOfWeights,
+             grid.numOfWeights, grid.values.begin() + node * grid.numOfWeights);
+      grid.filled[node] = true;
+    }
+  }
+
+  printSummary(job);
+  return grid;
+}
+
+// Candidates in a part of the grid w/o nodes computed by HAMMER are treated as
+// failed by HAMMER
+FFResult evalSurrogate(const SurrogateTable& table, size_t numOfWts,
+                       bool truthMatchOk, const string& mode,
+                       const GridVars& vars) {
+  auto result = FFResult{false, vector<double>(numOfWts, 1.0)};
+  if (!truthMatchOk) return result;
+
+  auto grid = table.find(mode);
+  if (grid == table.end()) return result;
+  auto weights = grid->second.eval(vars);
+  if (weights.empty()) return result;
+
+  result.hamOk   = true;
+  result.weights = move(weights);
+  return result;
+}
+
+// The grid and the helicity variables of each candidate in the entry range of
+// a tree, by entry offset in the range
+struct SurrogateInput {
+  Long64_t                     first;
+  vector<const SurrogateGrid*> grids;  // nullptr w/o a grid
+  vector<GridVars>             vars;
+};
+
+SurrogateInput readSurrogateInput(const SurrogateTable& table,
+                                  const string ntpIn, const TreeJob& job) {
+  auto [df, ignored] = prepInputGraph(ntpIn, job);
+  df = defineSurrogateInput(df);
+
+  auto size  = static_cast<size_t>(job.range.second - job.range.first);
+  auto input = SurrogateInput{job.range.first,
+                              vector<const SurrogateGrid*>(size, nullptr),
+                              vector<GridVars>(size)};
+  df.Foreach(
+      [&](ULong64_t entry, bool truthMatchOk, const string& mode,
+          const GridVars& vars) {
+        auto idx  = entry - input.first;
+        auto grid = table.find(mode);
+        if (truthMatchOk && grid != table.end())
+          input.grids[idx] = &grid->second;
+        input.vars[idx] = vars;
+      },
+      {INPUT_ENTRY_BR, "ham_tm_ok", "surrogate_mode", "surrogate_vars"});
+  return input;
+}
+
+// Weights of a block of consecutive entries, by entry offset in the block
+struct SurrogateBlock {
+  Long64_t       start = -1;
+  vector<double> weights{};  // by candidate, then by weight
+  vector<char>   ok{};
+  FFResult       result{false, {}};  // of the current candidate
+};
+
+// The candidates of a block are grouped by grid, and each grid is evaluated
+// on all of its candidates in one batch
+void evalSurrogateBlock(const SurrogateInput& input, size_t numOfWts,
+                        Long64_t start, SurrogateBlock& block) {
+  auto stop = min(start + SURROGATE_BATCH_SIZE,
+                  static_cast<Long64_t>(input.grids.size()));
+  block.start = start;
+  block.weights.assign((stop - start) * numOfWts, 1.0);
+  block.ok.assign(stop - start, false);
+
+  auto idxByGrid = map<const SurrogateGrid*, vector<Long64_t>>{};
+  for (auto idx = start; idx != stop; idx++)
+    if (input.grids[idx] != nullptr)
+      idxByGrid[input.grids[idx]].emplace_back(idx);
+
+  auto vars    = vector<GridVars>{};
+  auto weights = vector<double>{};
+  auto ok      = vector<char>{};
+  for (const auto& [grid, indices] : idxByGrid) {
+    vars.clear();
+    for (auto idx : indices) vars.emplace_back(input.vars[idx]);
+    grid->evalBatch(vars, weights, ok);
+
+    for (size_t pos = 0; pos != indices.size(); pos++) {
+      if (!ok[pos]) continue;
+      auto offset      = indices[pos] - start;
+      block.ok[offset] = true;
+      copy(weights.begin() + pos * numOfWts,
+           weights.begin() + (pos + 1) * numOfWts,
+           block.weights.begin() + offset * numOfWts);
+    }
+  }
+}
+
+// One grid for each mode found in the trees
+void trainSurrogate(SurrogateTable& table, HamPool& hams,
+                    const vector<FFVariant>& variants, const string ntpIn,
+                    const vector<TreeJob>& jobs) {
+  auto modes = map<string, SurrogateMode>{};
+  for (const auto& job : jobs) findSurrogateModes(modes, ntpIn, job);
+  if (modes.empty())
+    cout << "  WARN: No decay known to HAMMER for the surrogate." << endl;
+
+  for (const auto& [name, mode] : modes) {
+    cout << "Computing the surrogate grid of " << name << " w/ HAMMER" << endl;
+    table.emplace(name, evalSurrogateNodes(hams, variants, name, mode));
+  }
+}
+
+// Absolute errors of the interpolated weights w.r.t. the exact ones, by weight
+struct SurrogateErrors {
+  unsigned long  numOfCand   = 0;
+  unsigned long  numOfMissed = 0;  // w/o computed nodes around them
+  vector<double> sumAbs{};
+  vector<double> sumSq{};
+  vector<double> maxAbs{};
+
+  void add(const vector<double>& exact, const vector<double>& approx) {
+    if (sumAbs.empty()) {
+      sumAbs.assign(exact.size(), 0.0);
+      sumSq.assign(exact.size(), 0.0);
+      maxAbs.assign(exact.size(), 0.0);
+    }
+    numOfCand += 1;
+    for (size_t idx = 0; idx != exact.size(); idx++) {
+      auto diff = TMath::Abs(approx[idx] - exact[idx]);
+      sumAbs[idx] += diff;
+      sumSq[idx] += diff * diff;
+      maxAbs[idx] = max(maxAbs[idx], diff);
+    }
+  }
+
+  void merge(const SurrogateErrors& other) {
+    numOfCand += other.numOfCand;
+    numOfMissed += other.numOfMissed;
+    if (sumAbs.empty()) {
+      sumAbs = other.sumAbs;
+      sumSq  = other.sumSq;
+      maxAbs = other.maxAbs;
+      return;
+    }
+    for (size_t idx = 0; idx != other.sumAbs.size(); idx++) {
+      sumAbs[idx] += other.sumAbs[idx];
+      sumSq[idx] += other.sumSq[idx];
+      maxAbs[idx] = max(maxAbs[idx], other.maxAbs[idx]);
+    }
+  }
+
+  double mean(size_t idx) const { return sumAbs[idx] / numOfCand; }
+  double rms(size_t idx) const { return TMath::Sqrt(sumSq[idx] / numOfCand); }
+};
+
+// The holdout candidates are every 'holdout'-th candidate, by input entry.
+// The errors are reported for each mode, and for each variant: those of the
+// nominal weight, and the worst ones among the variations.
+void checkSurrogate(const SurrogateTable& table, HamPool& hams,
+                    const vector<FFVariant>& variants, const string ntpIn,
+                    TreeJob job, unsigned int holdout) {
+  auto numOfWts = numOfWeights(variants);
+  auto [df, ignored] = prepInputGraph(ntpIn, job);
+
+  df = df.Filter([holdout](ULong64_t entry) { return entry % holdout == 0; },
+                 {INPUT_ENTRY_BR});
+  df = defineFFResult(df, hams, variants, job);
+  df = defineSurrogateInput(df);
+
+  auto errorsBySlot = vector<map<string, SurrogateErrors>>(hams.size());
+  df.ForeachSlot(
+      [&](unsigned int slot, const FFResult* exact, bool truthMatchOk,
+          const string& mode, const GridVars& vars) {
+        if (!exact->hamOk || mode == "") return;
+        auto& errors = errorsBySlot[slot][mode];
+        auto approx = evalSurrogate(table, numOfWts, truthMatchOk, mode, vars);
+        if (approx.hamOk)
+          errors.add(exact->weights, approx.weights);
+        else
+          errors.numOfMissed += 1;
+      },
+      {"ff_result", "ham_tm_ok", "surrogate_mode", "surrogate_vars"});
+
+  auto errorsByMode = map<string, SurrogateErrors>{};
+  for (const auto& errorsOfSlot : errorsBySlot)
+    for (const auto& [mode, errors] : errorsOfSlot)
+      errorsByMode[mode].merge(errors);
+
+  cout << "Surrogate holdout for " << job.tree << ":" << endl;
+  if (errorsByMode.empty())
+    cout << "  WARN: No holdout candidates reweighted by HAMMER." << endl;
+
+  for (const auto& [mode, errors] : errorsByMode) {
+    cout << mode << ": " << errors.numOfCand << " holdout candidates, "
+         << errors.numOfMissed << " outside the computed grid" << endl;
+    if (errors.numOfCand == 0) continue;
+
+    size_t offset = 0;
+    for (const auto& variant : variants) {
+      cout << "  Absolute error of " << variant.brPrefix
+           << ": mean = " << errors.mean(offset)
+           << ", RMS = " << errors.rms(offset)
+           << ", max = " << errors.maxAbs[offset] << endl;
+
+      double maxRms = 0, maxAbs = 0;
+      for (int i = 1; i <= variant.numOfFFVar; i++) {
+        maxRms = max(maxRms, errors.rms(offset + i));
+        maxAbs = max(maxAbs, errors.maxAbs[offset + i]);
+      }
+      if (variant.numOfFFVar > 0)
+        cout << "  Worst absolute error of the " << variant.numOfFFVar
+             << " variations of " << variant.brPrefix << ": RMS = " << maxRms
+             << ", max = " << maxAbs << endl;
+      offset += 1 + variant.numOfFFVar;
+    }
+  }
+}
+
+// The table is computed for all trees, unless 'tablePath' exists already
+int reweightFileSurrogate(HamPool& hams, const vector<FFVariant>& variants,
+                          const string ntpIn, const string ntpOut,
+                          vector<TreeJob>& jobs, const string configHash,
+                          const string tablePath, unsigned int holdout) {
+  cout << "Reweighting " << ntpIn << " -> " << ntpOut << " w/ surrogate "
+       << tablePath << endl;
+
+  auto numOfWts     = numOfWeights(variants);
+  auto variantNames = vector<string>{};
+  for (const auto& variant : variants) variantNames.emplace_back(variant.name);
+
+  auto table = SurrogateTable{};
+  try {
+    if (ifstream(tablePath).good()) {
+      table =
+          loadSurrogateTable(tablePath, numOfWts, configHash, variantNames);
+    } else {
+      trainSurrogate(table, hams, variants, ntpIn, jobs);
+      saveSurrogateTable(table, tablePath, configHash, variantNames);
+    }
+  } catch (const exception& e) {
+    cout << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  auto writeOpts  = ROOT::RDF::RSnapshotOptions{};
+  writeOpts.fMode = "UPDATE";
+
+  for (auto& job : jobs) {
+    auto start = high_resolution_clock::now();
+
+    // the truth branches are only read here, the event loop below only
+    // looks up the interpolated weights of blocks of consecutive entries
+    auto input  = readSurrogateInput(table, ntpIn, job);
+    auto blocks = vector<SurrogateBlock>(hams.size());
+
+    auto [df, outputBrs] = prepInputGraph(ntpIn, job);
+    df                   = df.DefineSlot(
+        "ff_result",
+        [&input, &blocks, numOfWts](unsigned int slot, ULong64_t entry) {
+          auto  idx   = static_cast<Long64_t>(entry) - input.first;
+          auto& block = blocks[slot];
+          if (block.start < 0 || idx < block.start ||
+              idx >= block.start + SURROGATE_BATCH_SIZE)
+            evalSurrogateBlock(input, numOfWts,
+                               idx - idx % SURROGATE_BATCH_SIZE, block);
+
+          auto& result = block.result;
+          auto  offset = idx - block.start;
+          result.hamOk = block.ok[offset];
+          if (result.hamOk)
+            result.weights.assign(
+                block.weights.begin() + offset * numOfWts,
+                block.weights.begin() + (offset + 1) * numOfWts);
+          else
+            result.weights.assign(numOfWts, 1.0);
+          return static_cast<const FFResult*>(&result);
+        },
+        {INPUT_ENTRY_BR});
+    df = defineFFOutput(df, variants, outputBrs);
+    bookWeightSums(df, ntpIn, job);
+
+    if (ROOT::IsImplicitMTEnabled()) {
+      auto ntpTmp = ntpOut + ".tree";
+      snapshotWithEntries(df, job.tree, ntpTmp, outputBrs, false);
+      auto outputFile =
+          unique_ptr<TFile>(TFile::Open(ntpOut.c_str(), "UPDATE"));
+      copyTreeInEntryOrder(outputFile.get(), ntpTmp, job.tree, INPUT_ENTRY_BR);
+      outputFile->Close();
+      remove(ntpTmp.c_str());
+    } else {
+      df.Snapshot(job.tree, ntpOut, outputBrs, writeOpts);
+    }
+    writeEntryRange(ntpOut, job.tree, job.range);
+    writeWeightSums(ntpOut, job.tree, weightNames(variants), *job.weightSums);
+    cout << "Surrogate reweighting time for " << job.tree << ": "
+         << duration_cast<milliseconds>(high_resolution_clock::now() - start)
+                .count()
+         << " ms" << endl;
+
+    checkSurrogate(table, hams, variants, ntpIn, job, holdout);
+  }
+
+  return 0;
+}
+
+//////////////////
+// Input/output //
+//////////////////
+
+// Each non-empty line of a manifest is an input/output ntuple pair, separated
+// by whitespace. Lines starting w/ '#' are ignored.
+vector<pair<string, string>> parseManifest(const string manifest) {
+  auto result = vector<pair<string, string>>{};
+  auto input  = ifstream(manifest);
+  if (!input) throw runtime_error("Can't open manifest: " + manifest);
+
+  string line;
+  while (getline(input, line)) {
+    auto   buffer = stringstream(line);
+    string ntpIn, ntpOut;
+    if (!(buffer >> ntpIn) || ntpIn[0] == '#') continue;
+    if (!(buffer >> ntpOut))
+      throw runtime_error("No output ntuple for " + ntpIn + " in " + manifest);
+    result.emplace_back(ntpIn, ntpOut);
+  }
+
+  return result;
+}
+
+// Entry range to reweight for each tree
+vector<TreeJob> buildJobs(const string ntpIn, const vector<string>& trees,
+                          const vector<string>&       bMesons,
+                          const cxxopts::ParseResult& parsedArgs) {
+  bool hasRange = parsedArgs.count("first") || parsedArgs.count("last") ||
+                  parsedArgs.count("shard");
+  auto jobs     = vector<TreeJob>{};
+
+  for (int idx = 0; idx != trees.size(); idx++) {
+    auto entries = getEntries(ntpIn, trees[idx]);
+    auto range   = EntryRange{0, entries};
+
+    if (parsedArgs.count("first"))
+      range.first = min(parsedArgs["first"].as<Long64_t>(), entries);
+    if (parsedArgs.count("last"))
+      range.second = min(parsedArgs["last"].as<Long64_t>(), entries);
+    range.first = min(range.first, range.second);
+
+    if (parsedArgs.count("shard")) {
+      auto [shardIdx, numOfShards] =
+          parseShard(parsedArgs["shard"].as<string>());
+      range = shardRange(range, shardIdx, numOfShards);
+    }
+
+    jobs.emplace_back(TreeJob{trees[idx], bMesons[idx], range, hasRange});
+  }
+
+  return jobs;
+}
+
+int reweightFile(vector<HamPool>& hamPools, const vector<FFVariant>& variants,
+                 const string ntpIn, const string ntpOut, vector<TreeJob>& jobs,
+                 unsigned int nProcs, bool pipeline) {
+  cout << "Reweighting " << ntpIn << " -> " << ntpOut << endl;
+
+  if (nProcs > 1)
+    return reweightForked(hamPools[0], variants, ntpIn, ntpOut, jobs, nProcs);
+
+  if (ROOT::IsImplicitMTEnabled()) {
+    reweightTreesConcurrently(hamPools, variants, ntpIn, ntpOut, jobs);
+    return 0;
+  }
+
+  for (auto& job : jobs) {
+    if (pipeline)
+      reweightTreePipelined(hamPools[0], variants, ntpIn, ntpOut, job);
+    else
+      reweightTree(hamPools[0], variants, ntpIn, ntpOut, job);
+  }
+  return 0;
+}
+
+//////////
+// Main //
+//////////
+
+int main(int argc, char** argv) {
+  cxxopts::Options argOpts("ReweightRDX", "Reweight RDX FF w/ HAMMER.");
+
+  // clang-format off
+  argOpts.add_options()
+    // positional
+    ("ntpIn", "specify input ntuple.", cxxopts::value<string>())
+    ("ntpOut", "specify output ntuple.", cxxopts::value<string>())
+    ("extra", "unused.", cxxopts::value<vector<string>>())
+    // keyword
+    ("h,help", "print help.")
+    ("t,trees", "specify tree name.",
+     cxxopts::value<vector<string>>()
      ->default_value("TupleBminus/DecayTree,TupleB0/DecayTree"))
     ("b,bMesons", "specify B meson name.",
      cxxopts::value<vector<string>>()->default_value("b,b0"))
     ("r,run", "specify run.", cxxopts::value<string>()->default_value("run2"))
+    ("j,threads", "specify number of threads (1 disables implicit MT).",
+     cxxopts::value<unsigned int>()->default_value("1"))
+    ("p,procs", "specify number of forked worker processes.",
+     cxxopts::value<unsigned int>()->default_value("1"))
+    ("first", "specify first entry to reweight.",
+     cxxopts::value<Long64_t>())
+    ("last", "specify entry to stop at (exclusive).",
+     cxxopts::value<Long64_t>())
+    ("shard", "only reweight shard i of n, in the form of i/n.",
+     cxxopts::value<string>())
+    ("pipeline", "use a read/reweight/write pipeline w/ 'threads' workers.")
+    ("m,manifest", "specify a file of input/output ntuple pairs.",
+     cxxopts::value<string>())
+    ("v,variants", "specify FF variants to reweight in a single pass, or 'all'.",
+     cxxopts::value<vector<string>>()->default_value("nominal"))
+    ("eigen-vars", "vary B -> D(*) FFs w/ eigenvectors of a single *Var FF.")
+    ("ff-tensor", "store B -> D(*) FF tensors, needs --eigen-vars.")
+    ("i,incremental", "reuse the weights of candidates in a previous output.",
+     cxxopts::value<string>())
+    ("rate-cache", "specify a directory to cache HAMMER rate integrations.",
+     cxxopts::value<string>())
+    ("census", "only configure HAMMER for decays present in the inputs.")
+    ("surrogate", "interpolate weights w/ a surrogate table, computed and "
+     "saved if it doesn't exist.", cxxopts::value<string>())
+    ("surrogate-holdout", "check the surrogate on every n-th candidate.",
+     cxxopts::value<unsigned int>()->default_value("10"))
+    ("trace-level", "trace candidates: 1 for FF weights, 2 for also particles.",
+     cxxopts::value<unsigned int>()->default_value("0"))
+    ("trace-entries", "only trace these entries of the input trees (not "
+     "'rdfentry_').",
+     cxxopts::value<vector<Long64_t>>())
   ;
   // setup positional argument
   argOpts.parse_positional({"ntpIn", "ntpOut", "extra"});
@@ -1029,70 +2957,170 @@ int main(int argc, char** argv) {
     return 0;
   }
 
-  auto ntpIn   = parsedArgs["ntpIn"].as<string>();
-  auto ntpOut  = parsedArgs["ntpOut"].as<string>();
-  auto trees   = parsedArgs["trees"].as<vector<string>>();
-  auto bMesons = parsedArgs["bMesons"].as<vector<string>>();
-  auto run     = parsedArgs["run"].as<string>();
+  routeHamLog();
+  traceCfg.level = parsedArgs["trace-level"].as<unsigned int>();
+  if (parsedArgs.count("trace-entries"))
+    for (auto entry : parsedArgs["trace-entries"].as<vector<Long64_t>>())
+      traceCfg.entries.insert(entry);
+
+  auto trees    = parsedArgs["trees"].as<vector<string>>();
+  auto bMesons  = parsedArgs["bMesons"].as<vector<string>>();
+  auto run      = parsedArgs["run"].as<string>();
+  auto nThreads = parsedArgs["threads"].as<unsigned int>();
+  auto nProcs   = parsedArgs["procs"].as<unsigned int>();
+  bool pipeline = parsedArgs.count("pipeline");
+
+  auto variants = vector<FFVariant>{};
+  try {
+    variants = selectVariants(parsedArgs["variants"].as<vector<string>>());
+  } catch (const exception& e) {
+    cout << "ERROR: " << e.what() << endl;
+    return 1;
+  }
 
-  Hammer::Hammer ham{};
+  if (parsedArgs.count("ff-tensor")) {
+    if (!parsedArgs.count("eigen-vars")) {
+      cout << "ERROR: --ff-tensor needs --eigen-vars." << endl;
+      return 1;
+    }
+    auto variant = find_if(
+        variants.begin(), variants.end(),
+        [](const FFVariant& v) { return !v.ffEigenVarSpecs.empty(); });
+    if (variant != variants.end()) variant->ffTensor = true;
+  }
 
-  setDecays(ham);
-  setInputFF(ham, run);
-  auto ffSchemes = setOutputFF(ham);
+  // by default, each variation is a separately configured FF
+  if (!parsedArgs.count("eigen-vars")) {
+    for (auto& variant : variants) {
+      variant.ffEigenVarSpecs.clear();
+      variant.ffEigenSchemeByDecay.clear();
+    }
+  }
 
-  ham.setUnits("MeV");
-  ham.setOptions("ProcessCalc: {CheckForNaNs: true}");
-  ham.initRun();
+  // forking a process w/ running threads is not safe
+  if ((nThreads > 1 || pipeline) && nProcs > 1) {
+    cout << "ERROR: --threads/--pipeline and --procs can't be used together."
+         << endl;
+    return 1;
+  }
 
-  // only use SM Wilson coefficients
-  ham.specializeWCInWeights("BtoCTauNu", specializedWC);
-  ham.specializeWCInWeights("BtoCMuNu", specializedWC);
+  if ((parsedArgs.count("first") || parsedArgs.count("last")) &&
+      parsedArgs.count("shard")) {
+    cout << "ERROR: --first/--last and --shard can't be used together." << endl;
+    return 1;
+  }
 
-  // output option
-  auto writeOpts  = ROOT::RDF::RSnapshotOptions{};
-  writeOpts.fMode = "UPDATE";
+  // all input/output pairs share the same initialized HAMMERs
+  auto ntpPairs = vector<pair<string, string>>{};
+  if (parsedArgs.count("manifest"))
+    ntpPairs = parseManifest(parsedArgs["manifest"].as<string>());
+  if (parsedArgs.count("ntpIn") && parsedArgs.count("ntpOut"))
+    ntpPairs.emplace_back(parsedArgs["ntpIn"].as<string>(),
+                          parsedArgs["ntpOut"].as<string>());
+  if (ntpPairs.empty()) {
+    cout << "ERROR: No input/output ntuple specified." << endl;
+    return 1;
+  }
 
-  for (int idx = 0; idx != trees.size(); idx++) {
-    RNode          df     = static_cast<RNode>(RDataFrame(trees[idx], ntpIn));
-    auto           bMeson = bMesons[idx];
-    vector<string> outputBrs{"runNumber", "eventNumber"};
-    unsigned long  numOfEvt   = 0;
-    unsigned long  numOfEvtOk = 0;
+  if (parsedArgs.count("incremental")) {
+    if (ntpPairs.size() != 1) {
+      cout << "ERROR: --incremental needs a single input/output pair." << endl;
+      return 1;
+    }
+    if (ntpPairs[0].second == parsedArgs["incremental"].as<string>()) {
+      cout << "ERROR: The output must differ from the previous output." << endl;
+      return 1;
+    }
+  }
 
-    cout << "Handling " << trees[idx] << " with B meson name " << bMeson
-         << endl;
+  if (parsedArgs.count("surrogate")) {
+    if (pipeline || nProcs > 1 || parsedArgs.count("incremental") ||
+        parsedArgs.count("ff-tensor")) {
+      cout << "ERROR: --surrogate can't be used w/ --pipeline, --procs, "
+              "--incremental or --ff-tensor."
+           << endl;
+      return 1;
+    }
+    if (parsedArgs["surrogate-holdout"].as<unsigned int>() < 1) {
+      cout << "ERROR: --surrogate-holdout must be at least 1." << endl;
+      return 1;
+    }
+  }
+
+  // NOTE: With more than 1 thread, the output entries are restored to the
+  //       input order before the final write (see 'snapshotWithEntries').
+  //       In pipeline mode, each worker thread is a slot.
+  unsigned int nSlots = 1;
+  if (pipeline) {
+    ROOT::EnableThreadSafety();
+    nSlots = nThreads;
+  } else if (nThreads > 1) {
+    ROOT::EnableImplicitMT(nThreads);
+    nSlots = ROOT::GetThreadPoolSize();
+  }
+
+  auto decays = HAM_DECAYS;
+  if (parsedArgs.count("census")) {
+    decays = censusDecays(ntpPairs, trees, bMesons);
+    if (decays.empty()) {
+      cout << "  WARN: No known decay found, configuring all of them." << endl;
+      decays = HAM_DECAYS;
+    }
+    cout << "Decays present in the inputs:";
+    for (const auto& decay : decays) cout << " " << decay;
+    cout << endl;
+    for (auto& variant : variants) variant = restrictVariant(variant, decays);
+  }
 
-    // prepare aux output branches like q2_true
-    auto [dfAux, outputBrsAux] = prepAuxOutput(df, bMeson);
-    df                         = dfAux;
-    for (const auto& br : outputBrsAux) outputBrs.emplace_back(br);
-
-    // prepare HAMMER particles
-    tie(df, ignore) = prepHamInput(df, bMeson);
-
-    // reweight FF
-    auto reweight = reweightWrapper(ham, numOfEvt, numOfEvtOk, ffSchemes);
-    df            = df.Define("ff_result", reweight,
-                   {"ham_tm_ok", "is_tau", "part_B", "part_D", "part_D_dau0",
-                    "part_D_dau1", "part_D_dau2", "part_L", "part_NuL",
-                    "part_Mu", "part_NuMu", "part_NuTau", "part_photon_arr"});
-    df            = df.Define("ham_ok", "get<0>(ff_result)");
-    df            = df.Define("wff", "get<1>(ff_result)");
-    for (int i = 0; i < numOfFFVar; i++) {
-      auto outputBrName = "wff_var" + to_string(i + 1);
-      df = df.Define(outputBrName, "get<" + to_string(i + 2) + ">(ff_result)");
-      outputBrs.emplace_back(outputBrName);
+  // w/ implicit MT, all trees are reweighted concurrently, each w/ its own
+  // pool of HAMMERs (one fully initialized HAMMER per slot)
+  auto numOfPools = ROOT::IsImplicitMTEnabled() ? trees.size() : 1;
+  auto hamPools   = vector<HamPool>(numOfPools);
+  auto rateCacheDir =
+      parsedArgs.count("rate-cache") ? parsedArgs["rate-cache"].as<string>()
+                                     : "";
+  auto configHash = string{};
+  auto rateCache  = string{};
+  for (auto& hams : hamPools) {
+    for (unsigned int slot = 0; slot != nSlots; slot++) {
+      hams.emplace_back(make_unique<Hammer::Hammer>());
+      tie(configHash, rateCache) =
+          initHammer(*hams.back(), run, variants, decays, rateCacheDir);
     }
-    outputBrs.emplace_back("ham_ok");
-    outputBrs.emplace_back("wff");
+  }
 
-    df.Snapshot(trees[idx], ntpOut, outputBrs, writeOpts);
+  int exitCode = 0;
+  for (const auto& [ntpIn, ntpOut] : ntpPairs) {
+    auto jobs = buildJobs(ntpIn, trees, bMesons, parsedArgs);
+    if (parsedArgs.count("incremental")) {
+      auto ntpPrev = parsedArgs["incremental"].as<string>();
+      try {
+        for (auto& job : jobs)
+          job.prev = loadPrevResults(ntpIn, ntpPrev, job.tree, variants);
+      } catch (const exception& e) {
+        cout << "ERROR: " << e.what() << endl;
+        return 1;
+      }
+    }
+    if (parsedArgs.count("surrogate")) {
+      if (reweightFileSurrogate(
+              hamPools[0], variants, ntpIn, ntpOut, jobs, configHash,
+              parsedArgs["surrogate"].as<string>(),
+              parsedArgs["surrogate-holdout"].as<unsigned int>()))
+        exitCode = 1;
+    } else if (reweightFile(hamPools, variants, ntpIn, ntpOut, jobs, nProcs,
+                            pipeline))
+      exitCode = 1;
+  }
 
-    cout << "Total number of candidates: " << numOfEvt << endl;
-    cout << "Hammer reweighted candidates: " << numOfEvtOk << endl;
-    cout << "Reweighted fraction: "
-         << static_cast<float>(numOfEvtOk) / static_cast<float>(numOfEvt)
-         << endl;
+  // also store rates integrated for processes not in the cache yet
+  // NOTE: Forked workers integrate rates in their own HAMMERs, which are lost
+  if (rateCache != "" && nProcs == 1) {
+    auto hams = vector<Hammer::Hammer*>{};
+    for (auto& pool : hamPools)
+      for (auto& ham : pool) hams.emplace_back(ham.get());
+    saveRateCache(hams, rateCache);
   }
+
+  return exitCode;
 }
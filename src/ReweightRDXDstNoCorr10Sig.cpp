@@ -2,12 +2,6 @@
 // License: BSD 2-clause
 // Last Change: Thu Mar 23, 2023 at 02:12 AM -0400
 
-// Alex note to self: here the filename "default" just refers to the fact that the nominal
-// parameter values for the D** decays have been reset to the paper values (ie. not our shifted
-// values that we chose because the fit seemed to want to move these FF params far from the paper
-// values); the corresponding set nominal values and corresponding variations are thus different
-// from the reweighter script in this folder without "default" in the filename
-
 #include <algorithm>
 #include <array>
 #include <exception>
@@ -33,10 +27,12 @@
 #include <cxxopts.hpp>
 
 #include "const.h"
+#include "ff_params_dstnocorr10sig.h"
 #include "utils_general.h"
 #include "utils_ham.h"
 
 using namespace std;
+using namespace ffDstNoCorr10Sig;
 using ROOT::RDataFrame;
 using ROOT::RDF::RNode;
 using ROOT::VecOps::RVec;
@@ -89,476 +85,6 @@ map<string, complex<double>> specializedWC = {
     {"V_qRlL", 0}, {"T_qLlL", 0}, {"S_qLlR", 0}, {"S_qRlR", 0},
     {"V_qLlR", 0}, {"V_qRlR", 0}, {"T_qRlR", 0}};
 
-// clang-format off
-// +, -, +, -, ...
-vector<vector<string>> BtoDVars = {
-  // shifting 1-th param in + direction....
-  {
-    "{ap: [0.01564266061259705, -0.034768835742855116, -0.09341578728622298, 0.0]}",
-    "{a0: [0.07921507727285786, -0.20200574935567273, -0.32999651965104015, 0.0]}",
-  },
-  // shifting 1-th param in - direction....
-  {
-    "{ap: [0.015677339387402952, -0.03363116425714489, -0.08658421271377702, 0.0]}",
-    "{a0: [0.07948492272714215, -0.20799425064432725, -0.13000348034895984, 0.0]}",
-  },
-  // shifting 2-th param in + direction....
-  {
-    "{ap: [0.0156957728134992, -0.03274798737619618, -0.11173093154013228, 0.0]}",
-    "{a0: [0.07952054730874657, -0.20479549469640895, -0.22925983421113325, 0.0]}",
-  },
-  // shifting 2-th param in - direction....
-  {
-    "{ap: [0.015624227186500802, -0.035652012623803825, -0.06826906845986772, 0.0]}",
-    "{a0: [0.07917945269125344, -0.20520450530359102, -0.23074016578886677, 0.0]}",
-  },
-  // shifting 3-th param in + direction....
-  {
-    "{ap: [0.015686808500749508, -0.031712849151909125, -0.08969198838997502, 0.0]}",
-    "{a0: [0.07939582669134693, -0.19132668876796238, -0.22961524687243018, 0.0]}",
-  },
-  // shifting 3-th param in - direction....
-  {
-    "{ap: [0.015633191499250493, -0.03668715084809088, -0.09030801161002497, 0.0]}",
-    "{a0: [0.07930417330865308, -0.2186733112320376, -0.23038475312756984, 0.0]}",
-  },
-  // shifting 4-th param in + direction....
-  {
-    "{ap: [0.015564244420542984, -0.03420228477497694, -0.09000030258603699, 0.0]}",
-    "{a0: [0.07887140238985467, -0.20499939148119928, -0.22999994184165481, 0.0]}",
-  },
-  // shifting 4-th param in - direction....
-  {
-    "{ap: [0.015755755579457017, -0.03419771522502306, -0.089999697413963, 0.0]}",
-    "{a0: [0.07982859761014534, -0.2050006085188007, -0.2300000581583452, 0.0]}",
-  },
-  // shifting 5-th param in + direction....
-  {
-    "{ap: [0.015685136124387915, -0.03519607262617201, -0.09006434570610047, 0.0]}",
-    "{a0: [0.07914343789044714, -0.2048177906662987, -0.22998668416129328, 0.0]}",
-  },
-  // shifting 5-th param in - direction....
-  {
-    "{ap: [0.015634863875612085, -0.03320392737382799, -0.08993565429389952, 0.0]}",
-    "{a0: [0.07955656210955286, -0.20518220933370127, -0.23001331583870674, 0.0]}",
-  }
-};
-
-vector<vector<string>> BtoDstVars = {
-  // shifting 1-th param in + direction....
-  {
-    "{avec: [0.0016273098239999997, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 1-th param in - direction....
-  {
-    "{avec: [0.0008542410239999997, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 2-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, 0.006300510719999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 2-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.017664622079999998, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 3-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, 0.05295521280000001]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 3-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.1016585472]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 4-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.0005678190336, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 4-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00039774389759999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 5-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 0.0017432701439999997, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 5-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, -0.0015809256959999998, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 6-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0452245248]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 6-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, -0.039813043199999995]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 7-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [0.00035638471679999995, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 7-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [-0.0003084544512, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 8-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.012369100799999998, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 8-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, -0.0077306879999999994, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 9-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, 0.14920227839999997]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 9-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.22187074559999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 10-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.0025936458239999996, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 10-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.0015113495039999999, -0.00776934144, 2.7057407999999998e-05]}",
-  },
-  // shifting 11-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, 0.008465103359999997, 2.7057407999999998e-05]}",
-  },
-  // shifting 11-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.024003786239999998, 2.7057407999999998e-05]}",
-  },
-  // shifting 12-th param in + direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, 0.347134948608]}",
-  },
-  // shifting 12-th param in - direction....
-  {
-    "{avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}",
-    "{bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}",
-    "{cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}",
-    "{dvec: [0.002052497664, -0.00776934144, -0.34708083379199994]}",
-  }
-};
-
-vector<vector<string>> BtoD0starVars = {
-  // shifting 1-th param in + direction....
-  {
-    "{ztp: 3.0}",
-    "{zeta1: 0.6}",
-  },
-  // shifting 1-th param in - direction....
-  {
-    "{ztp: -2.5999999999999996}",
-    "{zeta1: 0.6}",
-  },
-  // shifting 2-th param in + direction....
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 1.2}",
-  },
-  // shifting 2-th param in - direction....
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 0.0}",
-  }
-};
-
-vector<vector<string>> BtoD1Vars = {
-  // shifting 1-th param in + direction....
-  {
-    "{tp: -1.2000000000000002}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting 1-th param in - direction....
-  {
-    "{tp: -2.0}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting 2-th param in + direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: 0.09999999999999998}",
-    "{tau2: 2.9}",
-  },
-  // shifting 2-th param in - direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: -1.1}",
-    "{tau2: 2.9}",
-  },
-  // shifting 3-th param in + direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 5.699999999999999}",
-  },
-  // shifting 3-th param in - direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 0.10000000000000009}",
-  },
-};
-
-vector<vector<string>> BtoD1starVars = {
-  // shifting 1-th param in + direction....
-  {
-    "{ztp: 3.0}",
-    "{zeta1: 0.6}",
-  },
-  // shifting 1-th param in - direction....
-  {
-    "{ztp: -2.5999999999999996}",
-    "{zeta1: 0.6}",
-  },
-  // shifting 2-th param in + direction....
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 1.2}",
-  },
-  // shifting 2-th param in - direction....
-  {
-    "{ztp: 0.2}",
-    "{zeta1: 0.0}",
-  },
-};
-
-vector<vector<string>> BtoD2starVars = {
-  // shifting 1-th param in + direction....
-  {
-    "{tp: -1.2000000000000002}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting 1-th param in - direction....
-  {
-    "{tp: -2.0}",
-    "{tau1: -0.5}",
-    "{tau2: 2.9}",
-  },
-  // shifting 2-th param in + direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: 0.09999999999999998}",
-    "{tau2: 2.9}",
-  },
-  // shifting 2-th param in - direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: -1.1}",
-    "{tau2: 2.9}",
-  },
-  // shifting 3-th param in + direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 5.699999999999999}",
-  },
-  // shifting 3-th param in - direction....
-  {
-    "{tp: -1.6}",
-    "{tau1: -0.5}",
-    "{tau2: 0.10000000000000009}",
-  },
-};
-
-// Various FF config
-map<string, vector<vector<string>>> ffVarSpecs = {
-  {"BD", BtoDVars},
-  {"BD*", BtoDstVars},
-  {"BD**0*", BtoD0starVars},
-  {"BD**1", BtoD1Vars},
-  {"BD**1*", BtoD1starVars},
-  {"BD**2*", BtoD2starVars},
-  {"BsDs**1", BtoD1Vars},
-  {"BsDs**2*", BtoD2starVars}
-};
-
-map<string, string> ffSchemeByDecay = {
-  {"BD", "BGL"},
-  {"BD*", "BGL"},
-  {"BD**0*", "BLR"},
-  {"BD**1", "BLR"},
-  {"BD**1*", "BLR"},
-  {"BD**2*", "BLR"},
-  {"BsDs**1", "BLR"},
-  {"BsDs**2*", "BLR"}
-};
-
-void setBtoDBGLDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {ChiT: 0.0005131}");
-  ham.setOptions(scheme + ": {ChiL: 0.006332}");
-  ham.setOptions(scheme + ": {BcStatesp: [6.329, 6.92, 7.02]}");
-  ham.setOptions(scheme + ": {BcStates0: [6.716, 7.121]}");
-  ham.setOptions(scheme + ": {ap: [0.01566, -0.0342, -0.09, 0.0]}");
-  ham.setOptions(scheme + ": {a0: [0.07935, -0.205, -0.23, 0.0]}");
-}
-
-void setBtoDstarBGLDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {Vcb: 0.0384}");
-  ham.setOptions(scheme + ": {Chim: 0.0003894}");
-  ham.setOptions(scheme + ": {Chip: 0.0005131}");
-  ham.setOptions(scheme + ": {ChimL: 0.019421}");
-  ham.setOptions(scheme + ": {BcStatesf: [6.739, 6.75, 7.145, 7.15]}");
-  ham.setOptions(scheme + ": {BcStatesg: [6.329, 6.92, 7.02]}");
-  ham.setOptions(scheme + ": {BcStatesP1: [6.275, 6.842, 7.25]}");
-  ham.setOptions(scheme + ": {avec: [0.0012407754239999998, -0.005682055679999999, -0.0243516672]}");
-  ham.setOptions(scheme + ": {bvec: [0.00048278146559999996, 8.117222399999999e-05, 0.0027057408]}");
-  ham.setOptions(scheme + ": {cvec: [2.39651328e-05, 0.0023192063999999996, -0.036334233599999995]}");
-  ham.setOptions(scheme + ": {dvec: [0.002052497664, -0.00776934144, 2.7057407999999998e-05]}");
-  // Alex note to self: gen_ham_params outputs setOptions(... abcderr: [...10 values...]) too,
-  // but I don't think Hammer needs the errors (they weren't set in previous iterations of Hammer
-  // reweighting, either)
-}
-
-void setBtoD0starBLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {zt1: 0.7}");
-  ham.setOptions(scheme + ": {ztp: 0.2}");
-  ham.setOptions(scheme + ": {zeta1: 0.6}");
-  ham.setOptions(scheme + ": {chi1: 0.0}");
-  ham.setOptions(scheme + ": {chi2: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laS: 0.76}");
-};
-
-void setBtoD1BLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {t1: 0.7}");
-  ham.setOptions(scheme + ": {tp: -1.6}");
-  ham.setOptions(scheme + ": {tau1: -0.5}");
-  ham.setOptions(scheme + ": {tau2: 2.9}");
-  ham.setOptions(scheme + ": {eta1: 0.0}");
-  ham.setOptions(scheme + ": {eta2: 0.0}");
-  ham.setOptions(scheme + ": {eta3: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laP: 0.8}");
-};
-
-void setBtoD1starBLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {zt1: 0.7}");
-  ham.setOptions(scheme + ": {ztp: 0.2}");
-  ham.setOptions(scheme + ": {zeta1: 0.6}");
-  ham.setOptions(scheme + ": {chi1: 0.0}");
-  ham.setOptions(scheme + ": {chi2: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laS: 0.76}");
-};
-
-void setBtoD2starBLRDefault(Hammer::Hammer& ham, const string scheme) {
-  ham.setOptions(scheme + ": {as: 0.26}");
-  ham.setOptions(scheme + ": {mb: 4.71}");
-  ham.setOptions(scheme + ": {mc: 1.31}");
-  ham.setOptions(scheme + ": {t1: 0.7}");
-  ham.setOptions(scheme + ": {tp: -1.6}");
-  ham.setOptions(scheme + ": {tau1: -0.5}");
-  ham.setOptions(scheme + ": {tau2: 2.9}");
-  ham.setOptions(scheme + ": {eta1: 0.0}");
-  ham.setOptions(scheme + ": {eta2: 0.0}");
-  ham.setOptions(scheme + ": {eta3: 0.0}");
-  ham.setOptions(scheme + ": {laB: 0.4}");
-  ham.setOptions(scheme + ": {laP: 0.8}");
-};
-
-map<string, function<void(Hammer::Hammer&, const string)>>
-ffSchemeDefaultsByDecay = {
-  {"BD", setBtoDBGLDefault},
-  {"BD*", setBtoDstarBGLDefault},
-  {"BD**0*", setBtoD0starBLRDefault},
-  {"BD**1", setBtoD1BLRDefault},
-  {"BD**1*", setBtoD1starBLRDefault},
-  {"BD**2*", setBtoD2starBLRDefault},
-  {"BsDs**1", setBtoD1BLRDefault},
-  {"BsDs**2*", setBtoD2starBLRDefault}
-};
-// clang-format on
-
-const int numOfFFVar = 24;
-
 string decayDescr(const string decay) {
   // the pattern seems to be you just need to insert the word "to"
   // I'm going to assume the fact (that should be fine for our analysis) that the
@@ -53,12 +53,21 @@ def parse_input():
         help="specify FF params to print",
     )
 
+    parser.add_argument(
+        "-e",
+        "--eigen",
+        action="store_true",
+        help="print B -> D(*) variations as eigenvector variations of BGLVar",
+    )
+
     return parser.parse_args()
 
 ###########
 # Helpers #
 ###########
 
+PRINT_EIGEN = False
+
 # need to determine if some numpy scalars/vectors are equal, modulo some floating point arithmetic
 # and overall minus signs
 def almost_equal(a, b, z=1e-14):
@@ -87,6 +96,13 @@ def fmt_dict_as_cpp_map(dct):
         output += elem
     return output[:-2] + "},"
 
+# print the +/- variations as maps for setFFEigenvectors
+def print_param_eigen(var_pos):
+    var_neg = {k: -v for k, v in var_pos.items()}
+    print(f"  {fmt_dict_as_cpp_map(var_pos)}")
+    print(f"  {fmt_dict_as_cpp_map(var_neg)}")
+
+
 def eval_fake_sandbox(code, add_vars):
     loc = dict()
     sandbox = {k: v for k, v in globals().items()}
@@ -149,6 +165,12 @@ def gen_param_shifted_BtoDBGL(
         var_a0 = np.insert(var_a0, 0, var_a00)
         var_a0 = np.append(var_a0, 0.0)
 
+        if PRINT_EIGEN:
+            var_pos = {f"delta_ap{j}": var_ap[j] for j in range(3)}
+            var_pos.update({f"delta_a0{j}": var_a0[j] for j in range(3)})
+            print_param_eigen(var_pos)
+            continue
+
         if verbose:
             print(f"  // shifting in {i+1}-th direction (+)...")
             print("  {")
@@ -199,6 +221,16 @@ def gen_param_shifted_BtoDstarBGL(
         var_c = var_values[6:9]
         var_d = var_values[9:12]
 
+        if PRINT_EIGEN:
+            var_pos = {}
+            for names, delta in zip(
+                [["a0", "a1", "a2"], ["b0", "b1", "b2"], ["c1", "c2", "c3"], ["d0", "d1", "d2"]],
+                [var_a, var_b, var_c, var_d],
+            ):
+                var_pos.update({"delta_" + n: d for n, d in zip(names, delta)})
+            print_param_eigen(var_pos)
+            continue
+
         if verbose:
             print(f"  // shifting in {i+1}-th direction (+)...")
             print("  {")
@@ -266,6 +298,7 @@ def gen_param_shifted_BtoDstarstarBLR(
 
 if __name__ == "__main__":
     args = parse_input()
+    PRINT_EIGEN = args.eigen
 
     with open(args.input) as f:
         cfg = yaml.safe_load(f)
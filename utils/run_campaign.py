@@ -0,0 +1,222 @@
+#!/usr/bin/env python
+#
+# Author: Yipeng Sun
+#
+# Run a samples x variants reweighting campaign concurrently, under a CPU and
+# memory budget.
+
+import os
+import shlex
+import subprocess
+import time
+import yaml
+import uproot
+
+from argparse import ArgumentParser
+from dataclasses import dataclass, field
+from pathlib import Path
+
+
+#######################
+# Command line parser #
+#######################
+
+
+def parse_input():
+    parser = ArgumentParser(description="run a reweighting campaign.")
+
+    parser.add_argument("manifest", help="specify campaign manifest (YAML).")
+
+    parser.add_argument(
+        "-c",
+        "--cpus",
+        type=int,
+        default=os.cpu_count(),
+        help="specify number of CPUs to use.",
+    )
+
+    parser.add_argument(
+        "-m",
+        "--mem",
+        type=float,
+        default=None,
+        help="specify memory budget in GB (default: from manifest).",
+    )
+
+    parser.add_argument(
+        "-n",
+        "--dry-run",
+        action="store_true",
+        help="only print the jobs and their estimated cost.",
+    )
+
+    parser.add_argument(
+        "-f",
+        "--force",
+        action="store_true",
+        help="rerun jobs w/ existing outputs.",
+    )
+
+    return parser.parse_args()
+
+
+###########
+# Helpers #
+###########
+
+
+@dataclass
+class Job:
+    name: str
+    cmd: list
+    output: Path
+    tmp_output: Path
+    log: Path
+    cpus: int
+    mem: float
+    cost: float = 0.0
+    proc: subprocess.Popen = field(default=None, repr=False)
+    log_file: object = field(default=None, repr=False)
+    start: float = 0.0
+
+
+def count_entries(ntp, trees):
+    # the number of candidates is a good proxy for the reweighting time
+    with uproot.open(ntp) as f:
+        return sum(f[t].num_entries for t in trees if t in f)
+
+
+def build_jobs(spec, mem_budget):
+    bin_dir = Path(spec.get("bin_dir", "bin"))
+    output_dir = Path(spec.get("output_dir", "gen"))
+    log_dir = Path(spec.get("log_dir", output_dir))
+    trees = spec.get("trees", ["TupleBminus/DecayTree", "TupleB0/DecayTree"])
+    defaults = spec.get("defaults", {})
+
+    jobs = []
+    for sample in spec["samples"]:
+        sample = Path(sample)
+        entries = count_entries(sample, trees)
+
+        for exe, variant in spec["variants"].items():
+            variant = {**defaults, **(variant or {})}
+            threads = variant.get("threads", 1)
+            suffix = variant.get("suffix", "reweighted")
+
+            output = output_dir / f"{sample.stem}-{suffix}.root"
+            # written to a temporary path and only renamed on success, so that
+            # failed jobs don't leave partial outputs that look done
+            tmp_output = output_dir / f"{sample.stem}-{suffix}.tmp.root"
+            log = log_dir / f"{sample.stem}-{suffix}.log"
+            cmd = [str(bin_dir / exe), str(sample), str(tmp_output)]
+            cmd += shlex.split(variant.get("args", ""))
+            if threads > 1:
+                cmd += ["-j", str(threads)]
+
+            # estimated wall time: init + per-candidate cost, spread over threads
+            cost = variant.get("init_cost", 60.0) + entries * variant.get(
+                "cand_cost", 1e-3
+            ) / threads
+            mem = min(variant.get("mem", 1.0) * threads, mem_budget)
+
+            jobs.append(
+                Job(
+                    f"{exe}:{sample.stem}",
+                    cmd,
+                    output,
+                    tmp_output,
+                    log,
+                    threads,
+                    mem,
+                    cost,
+                )
+            )
+
+    return jobs
+
+
+def launch(job):
+    job.log.parent.mkdir(parents=True, exist_ok=True)
+    job.output.parent.mkdir(parents=True, exist_ok=True)
+    # the reweighters open their outputs in UPDATE mode, so stale temporary
+    # outputs of previous runs must not be reused. The previous final output
+    # is kept until 'finish' replaces it w/ a successful one.
+    job.tmp_output.unlink(missing_ok=True)
+    job.log_file = open(job.log, "w")
+    job.proc = subprocess.Popen(
+        job.cmd, stdout=job.log_file, stderr=subprocess.STDOUT
+    )
+    job.start = time.time()
+    print(f"Started {job.name} (cpus: {job.cpus}, mem: {job.mem} GB)")
+
+
+def finish(job):
+    job.log_file.close()
+    ok = job.proc.returncode == 0 and job.tmp_output.exists()
+    if ok:
+        job.tmp_output.replace(job.output)
+
+    if ok:
+        status = "OK"
+    elif job.proc.returncode == 0:
+        status = "FAILED (no output)"
+    else:
+        status = f"FAILED ({job.proc.returncode})"
+    print(f"Finished {job.name} in {time.time() - job.start:.0f} s: {status}")
+    print(f"  log: {job.log}")
+    if not ok and job.tmp_output.exists():
+        print(f"  partial output kept at: {job.tmp_output}")
+    return ok
+
+
+def schedule(jobs, cpus, mem):
+    # longest job first, so that the cheap ones fill the gaps at the end
+    pending = sorted(jobs, key=lambda j: j.cost, reverse=True)
+    running = []
+    ok = True
+
+    while pending or running:
+        for job in running[:]:
+            if job.proc.poll() is not None:
+                ok = finish(job) and ok
+                running.remove(job)
+
+        used_cpus = sum(j.cpus for j in running)
+        used_mem = sum(j.mem for j in running)
+        for job in pending[:]:
+            # a job that doesn't fit in an empty node still runs, but alone
+            fits = used_cpus + job.cpus <= cpus and used_mem + job.mem <= mem
+            if fits or not running:
+                launch(job)
+                pending.remove(job)
+                running.append(job)
+                used_cpus += job.cpus
+                used_mem += job.mem
+
+        time.sleep(1)
+
+    return ok
+
+
+########
+# Main #
+########
+
+if __name__ == "__main__":
+    args = parse_input()
+
+    with open(args.manifest) as f:
+        spec = yaml.safe_load(f)
+
+    mem = args.mem if args.mem else spec.get("mem_budget", 16.0)
+    jobs = build_jobs(spec, mem)
+    if not args.force:
+        jobs = [j for j in jobs if not j.output.exists()]
+
+    print(f"Jobs to run: {len(jobs)}, w/ {args.cpus} CPUs and {mem} GB memory")
+    for job in sorted(jobs, key=lambda j: j.cost, reverse=True):
+        print(f"  {job.name}: estimated {job.cost:.0f} s")
+        print(f"    {' '.join(job.cmd)}")
+
+    if not args.dry_run:
+        exit(0 if schedule(jobs, args.cpus, mem) else 1)